@@ -0,0 +1,111 @@
+//
+// Created on 16.10.26.
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include "Benchmark.h"
+
+namespace {
+    std::atomic<std::size_t> allocations{ 0 };
+
+    void* allocate(std::size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+            return memory;
+        }
+        throw std::bad_alloc{};
+    }
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace benchmark {
+    std::size_t allocationCount() noexcept {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+    Suite::Suite(std::string filter, std::chrono::milliseconds minimumTime)
+        : mFilter{ std::move(filter) }, mMinimumTime{ minimumTime } {}
+
+    void Suite::run(const std::string& name, std::size_t bytesPerIteration, const std::function<void()>& body) {
+        if (!mFilter.empty() && name.find(mFilter) == std::string::npos) {
+            return;
+        }
+        Result result{ name, bytesPerIteration, 0, 0.0, 0.0, std::nullopt };
+        try {
+            body();
+            const auto allocationsBefore = allocationCount();
+            const auto start = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::steady_clock::duration::zero();
+            do {
+                body();
+                result.iterations++;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (elapsed < mMinimumTime);
+            const auto iterations = static_cast<double>(result.iterations);
+            result.nanosecondsPerIteration = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+            result.allocationsPerIteration = static_cast<double>(allocationCount() - allocationsBefore) / iterations;
+        } catch (std::exception& e) {
+            result.error = e.what();
+        }
+        std::cerr << "." << std::flush;
+        mResults.push_back(std::move(result));
+    }
+
+    const std::vector<Result>& Suite::results() const noexcept {
+        return mResults;
+    }
+
+    void Suite::print(std::ostream& stream) const {
+        stream << '\n' << std::left << std::setw(60) << "benchmark" << std::right
+               << std::setw(12) << "iterations" << std::setw(16) << "ns/iteration" << std::setw(12) << "ns/byte"
+               << std::setw(16) << "allocs/iter" << std::setw(14) << "allocs/byte" << '\n';
+        for (const auto& result : mResults) {
+            stream << std::left << std::setw(60) << result.name << std::right;
+            if (result.error) {
+                stream << "  failed: " << *result.error << '\n';
+                continue;
+            }
+            stream << std::fixed << std::setw(12) << result.iterations
+                   << std::setw(16) << std::setprecision(1) << result.nanosecondsPerIteration;
+            if (result.bytes > 0) {
+                stream << std::setw(12) << std::setprecision(3) << result.nanosecondsPerIteration / static_cast<double>(result.bytes);
+            } else {
+                stream << std::setw(12) << "-";
+            }
+            stream << std::setw(16) << std::setprecision(1) << result.allocationsPerIteration;
+            if (result.bytes > 0) {
+                stream << std::setw(14) << std::setprecision(5) << result.allocationsPerIteration / static_cast<double>(result.bytes);
+            } else {
+                stream << std::setw(14) << "-";
+            }
+            stream << '\n';
+        }
+    }
+}
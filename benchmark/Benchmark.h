@@ -0,0 +1,55 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <chrono>
+
+namespace benchmark {
+    struct Result {
+        std::string name;
+        // bytes processed by a single iteration, 0 if the benchmark has no meaningful size
+        std::size_t bytes;
+        std::size_t iterations;
+        double nanosecondsPerIteration;
+        double allocationsPerIteration;
+        std::optional<std::string> error;
+    };
+
+    /**
+     * Runs benchmark bodies repeatedly until they took at least the minimum
+     * time and records the time and the number of heap allocations per
+     * iteration. Allocations are counted by replacing the global operator
+     * new, so they include everything the body allocates indirectly.
+     */
+    class Suite {
+    public:
+        explicit Suite(std::string filter = {}, std::chrono::milliseconds minimumTime = std::chrono::milliseconds{ 250 });
+
+        /**
+         * Runs the body once for warming up and then measures it. Exceptions
+         * thrown by the body are recorded as error of the result.
+         */
+        void run(const std::string& name, std::size_t bytesPerIteration, const std::function<void()>& body);
+
+        [[nodiscard]] const std::vector<Result>& results() const noexcept;
+
+        void print(std::ostream& stream) const;
+
+    private:
+        std::string mFilter;
+        std::chrono::milliseconds mMinimumTime;
+        std::vector<Result> mResults;
+    };
+
+    /**
+     * Number of calls to the global operator new since the program started.
+     */
+    [[nodiscard]] std::size_t allocationCount() noexcept;
+}
@@ -0,0 +1,39 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include "../src/serial/AbstractSerial.h"
+
+namespace benchmark {
+    /**
+     * Serial port which drops everything, so only the cost of producing the
+     * bytes is measured. Behaves like SerialTestImpl otherwise.
+     */
+    class NullSerial : public AbstractSerial {
+    public:
+        void writeData(std::byte) override { mWritten++; }
+
+        void writeData(std::span<const std::byte> data) override { mWritten += data.size(); }
+
+        bool drain() override { return true; }
+
+        std::optional<std::string> reciveByte() override { return std::nullopt; }
+
+        std::vector<std::byte> reciveBytes() override { return {}; }
+
+        std::optional<std::byte> reciveByteFor(std::chrono::milliseconds) override { return std::nullopt; }
+
+        [[nodiscard]] bool isOpen() const override { return true; }
+
+        [[nodiscard]] std::optional<std::string> errorMessage() const override { return std::nullopt; }
+
+        [[nodiscard]] unsigned int baudrate() const noexcept override { return 115200; }
+
+        [[nodiscard]] std::size_t written() const noexcept { return mWritten; }
+
+    private:
+        std::size_t mWritten{ 0 };
+    };
+}
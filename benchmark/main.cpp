@@ -0,0 +1,254 @@
+//
+// Created on 16.10.26.
+//
+
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include "Benchmark.h"
+#include "NullSerial.h"
+#include "../includes/intelhexclass.h"
+#include "../src/json/ConfigManager.h"
+#include "../src/loader/DataSendManager.h"
+#include "../src/loader/HexReader.h"
+#include "../src/loader/BinReader.h"
+#include "../test/testClasses/PtyLoopback.h"
+#include "../src/units/parse/unitParser.h"
+
+/*
+ * Micro benchmarks of the hot paths between the firmware file and the serial
+ * port. Build with optimizations (-DCMAKE_BUILD_TYPE=Release) and run
+ *   benchmarks [filter]
+ * to run every benchmark whose name contains the filter.
+ */
+
+namespace {
+    using namespace CustomDataTypes::ComputerScience::literals;
+
+    constexpr std::size_t kilobyte = 1024;
+    constexpr std::size_t megabyte = 1024 * kilobyte;
+
+    std::string configJson(std::size_t bytesPerBurst, bool acknowledged = false, const std::string& burstDelay = "0ms") {
+        std::stringstream json;
+        json << R"({
+  "device": {
+    "general": { "id": "benchmark", "vendor": "None", "arch": "None", "subarch": "None", "name": "Benchmark" },
+    "flash": { "total": "64MB", "available": "64MB", "pageSize": 128 },
+    "eeprom": { "total": "1KB", "available": "1KB" }
+  },
+  "serial": {
+    "general": { "mode": "8N1", "bytesPerBurst": )" << bytesPerBurst << R"(, "metadataByteSize": 4, "minBaudrate": 9600, "maxBaudrate": 115200 },
+    "write": { "waitTimeForReset": "0ms", "eepromBurstDelay": "0ms", "flashBurstDelay": ")" << burstDelay << R"(" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": "false")"
+             << (acknowledged ? R"(, "ackByte": "0x06", "ackWindow": 4, "ackTimeout": "100ms")" : "") << R"( }
+  },
+  "binary": { "format": "Intel Hex", "transfer": "linear", "compression": "none", "unusedFlashByte": "0xFF" }
+})";
+        return json.str();
+    }
+
+    std::filesystem::path writeFile(const std::filesystem::path& path, std::string_view content) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+        stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+        return path;
+    }
+
+    /**
+     * Intel Hex file with 16 byte data records and an extended linear
+     * address record at every 64KB boundary, like the output of objcopy.
+     */
+    std::string syntheticHex(std::size_t size) {
+        std::string hex;
+        hex.reserve(size / 16 * 44 + size / (64 * kilobyte) * 17 + 32);
+        constexpr auto digits = "0123456789ABCDEF";
+        const auto record = [&](std::uint8_t type, std::uint16_t address, const std::uint8_t* data, std::uint8_t length) {
+            std::uint8_t checksum = static_cast<std::uint8_t>(length + (address >> 8) + (address & 0xFF) + type);
+            const auto put = [&](std::uint8_t value) {
+                hex.push_back(digits[value >> 4]);
+                hex.push_back(digits[value & 0x0F]);
+            };
+            hex.push_back(':');
+            put(length);
+            put(static_cast<std::uint8_t>(address >> 8));
+            put(static_cast<std::uint8_t>(address & 0xFF));
+            put(type);
+            for (std::uint8_t i = 0; i < length; ++i) {
+                put(data[i]);
+                checksum = static_cast<std::uint8_t>(checksum + data[i]);
+            }
+            put(static_cast<std::uint8_t>(-checksum & 0xFF));
+            hex.push_back('\n');
+        };
+
+        std::array<std::uint8_t, 16> data{};
+        for (std::size_t address = 0; address < size; address += data.size()) {
+            if (address % (64 * kilobyte) == 0) {
+                const std::array<std::uint8_t, 2> upper{ static_cast<std::uint8_t>(address >> 24), static_cast<std::uint8_t>(address >> 16) };
+                record(0x04, 0, upper.data(), 2);
+            }
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<std::uint8_t>((address + i) * 7 + (address >> 8));
+            }
+            record(0x00, static_cast<std::uint16_t>(address & 0xFFFF), data.data(), static_cast<std::uint8_t>(data.size()));
+        }
+        record(0x01, 0, nullptr, 0);
+        return hex;
+    }
+
+    std::string sizeName(std::size_t size) {
+        return size >= megabyte ? std::to_string(size / megabyte) + "MB" : std::to_string(size / kilobyte) + "KB";
+    }
+
+    void intelHexBenchmarks(benchmark::Suite& suite) {
+        for (const auto size : { 32 * kilobyte, 1 * megabyte, 16 * megabyte }) {
+            const auto hex = syntheticHex(size);
+            suite.run("intelhex decode " + sizeName(size), size, [&hex]() {
+                intelhex decoder;
+                decoder.decode(hex);
+            });
+            suite.run("intelhex decode parallel " + sizeName(size), size, [&hex]() {
+                intelhex decoder;
+                decoder.decode(hex, std::thread::hardware_concurrency());
+            });
+        }
+    }
+
+    void writeToStreamBenchmarks(benchmark::Suite& suite, const std::filesystem::path& folder) {
+        const firmware::json::config::ConfigManager config{ writeFile(folder / "writeToStream.json", configJson(128)) };
+        for (const auto size : { 32 * kilobyte, 1 * megabyte }) {
+            const auto file = writeFile(folder / ("image" + sizeName(size) + ".hex"), syntheticHex(size));
+            const firmware::reader::HexReader reader{ file.string(), 64_MB };
+            if (!reader) {
+                std::cerr << *reader.errorMessage() << std::endl;
+                continue;
+            }
+            firmware::serial::DataSendManager manager{ config, std::make_unique<benchmark::NullSerial>(), false };
+            suite.run("HexReader::writeToStream " + sizeName(size), size, [&]() {
+                reader.writeToStream(manager, [](double) {});
+                manager.flush();
+            });
+        }
+    }
+
+    void framingBenchmarks(benchmark::Suite& suite, const std::filesystem::path& folder) {
+        const std::vector<std::byte> data(1 * megabyte, std::byte{ 0x5A });
+        for (const std::size_t bytesPerBurst : { 16UL, 64UL, 256UL, 1024UL }) {
+            const firmware::json::config::ConfigManager config{
+                writeFile(folder / ("framing" + std::to_string(bytesPerBurst) + ".json"), configJson(bytesPerBurst)) };
+            firmware::serial::DataSendManager manager{ config, std::make_unique<benchmark::NullSerial>(), false };
+            suite.run("DataSendManager::write 1MB bytesPerBurst=" + std::to_string(bytesPerBurst), data.size(), [&]() {
+                manager.write(data);
+                manager.flush();
+            });
+            suite.run("DataSendManager::bufferedWrite 64KB bytesPerBurst=" + std::to_string(bytesPerBurst), 64 * kilobyte, [&]() {
+                for (std::size_t i = 0; i < 64 * kilobyte; ++i) {
+                    manager.bufferedWrite(data[i]);
+                }
+                manager.flush();
+            });
+        }
+    }
+
+#ifdef __linux__
+    /**
+     * Flashes through SerialImpl into a pseudo terminal, once without delays
+     * for the throughput of the real port path and once with a burst delay
+     * to see how exactly the bursts are paced.
+     */
+    void loopbackBenchmarks(benchmark::Suite& suite, const std::filesystem::path& folder, std::vector<std::string>& reports) {
+        constexpr std::size_t size = 64 * kilobyte;
+        const std::vector<char> content(size, 0x5A);
+        const auto image = writeFile(folder / "loopback.bin", { content.data(), content.size() });
+        const firmware::reader::BinReader reader{ image.string(), 64_MB };
+
+        for (const std::string delay : { "0ms", "1ms" }) {
+            const firmware::json::config::ConfigManager config{
+                writeFile(folder / ("loopback" + delay + ".json"), configJson(256, false, delay)) };
+            PtyLoopback loopback;
+            if (!loopback) {
+                std::cerr << *loopback.errorMessage() << std::endl;
+                return;
+            }
+            const std::string& device = loopback.devicePath();
+            firmware::serial::DataSendManager manager{ config, { device, 115200 }, std::chrono::milliseconds{ 0 } };
+            const auto name = "SerialImpl pty loopback 64KB flashBurstDelay=" + delay;
+            suite.run(name, size, [&]() {
+                loopback.clear();
+                reader.writeToStream(manager, [](double) {});
+                manager.flush();
+                if (!loopback.waitFor(size, std::chrono::seconds{ 10 })) {
+                    throw std::runtime_error("the loopback didn't receive the whole image");
+                }
+            });
+
+            const auto delayTime = std::chrono::microseconds{ *CustomDataTypes::parseUnit<std::chrono::milliseconds>(delay) };
+            const auto report = loopback.report(delay == "0ms" ? std::chrono::microseconds{ 500 } : delayTime / 2, delayTime);
+            std::stringstream line;
+            line << name << ": " << std::fixed << std::setprecision(0) << report.bytesPerSecond << " B/s, "
+                 << report.bursts << " bursts, mean gap " << report.meanGap.count() << "us, max pacing error "
+                 << report.maxPacingError.count() << "us";
+            reports.push_back(line.str());
+        }
+    }
+#endif
+
+    template<firmware::json::config::JsonOptions option>
+    void getJSONValueBenchmark(benchmark::Suite& suite, const firmware::json::config::ConfigManager& config) {
+        using optionStruct = firmware::json::config::DeviceOptions<option>;
+        suite.run(std::string{ "getJSONValue " } + optionStruct::jsonKey, 0, [&config]() {
+            [[maybe_unused]] const auto value = config.getJSONValue<option>();
+        });
+    }
+
+    template<std::size_t... options>
+    void getJSONValueBenchmarks(benchmark::Suite& suite, const firmware::json::config::ConfigManager& config, std::index_sequence<options...>) {
+        (getJSONValueBenchmark<static_cast<firmware::json::config::JsonOptions>(options)>(suite, config), ...);
+    }
+
+    void parseUnitBenchmarks(benchmark::Suite& suite) {
+        using CustomDataTypes::ComputerScience::byte;
+        for (const std::string input : { "32KB", "1023B", "16MB" }) {
+            suite.run("parseUnit<byte> " + input, input.size(), [&input]() {
+                if (!CustomDataTypes::parseUnit<byte>(input)) {
+                    throw std::runtime_error("unable to parse " + input);
+                }
+            });
+        }
+        for (const std::string input : { "9ms", "100ms", "1s" }) {
+            suite.run("parseUnit<milliseconds> " + input, input.size(), [&input]() {
+                if (!CustomDataTypes::parseUnit<std::chrono::milliseconds>(input)) {
+                    throw std::runtime_error("unable to parse " + input);
+                }
+            });
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    benchmark::Suite suite{ argc > 1 ? argv[1] : "" };
+    const auto folder = std::filesystem::temp_directory_path() / "firmware_loader_benchmarks";
+
+    intelHexBenchmarks(suite);
+    writeToStreamBenchmarks(suite, folder);
+    framingBenchmarks(suite, folder);
+    std::vector<std::string> loopbackReports;
+#ifdef __linux__
+    loopbackBenchmarks(suite, folder, loopbackReports);
+#endif
+    const firmware::json::config::ConfigManager config{ writeFile(folder / "options.json", configJson(64, true)) };
+    getJSONValueBenchmarks(suite, config,
+            std::make_index_sequence<static_cast<std::size_t>(firmware::json::config::JsonOptions::unusedFlashByte) + 1>{});
+    parseUnitBenchmarks(suite);
+
+    suite.print(std::cout);
+    for (const auto& report : loopbackReports) {
+        std::cout << report << '\n';
+    }
+    std::filesystem::remove_all(folder);
+    return 0;
+}
@@ -64,7 +64,12 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <span>
+#include <thread>
+#include <algorithm>
 #ifdef _MSC_FULL_VER
 #include <stdio.h>
 #else
@@ -90,6 +95,111 @@ enum intelhexRecordType {
     NO_OF_RECORD_TYPES
 };
 
+/*******************************************************************************
+* Value returned by hexNibbleTable for chars which aren't HEX digits.
+*******************************************************************************/
+constexpr unsigned char INVALID_NIBBLE = 0xFF;
+
+/*******************************************************************************
+* Lookup table converting an ASCII char to its nibble value.
+*******************************************************************************/
+constexpr std::array<unsigned char, 256> hexNibbleTable = []
+{
+    std::array<unsigned char, 256> table{};
+
+    for (auto& entry : table)
+    {
+        entry = INVALID_NIBBLE;
+    }
+    for (unsigned char x = 0; x < 10; x++)
+    {
+        table['0' + x] = x;
+    }
+    for (unsigned char x = 0; x < 6; x++)
+    {
+        table['A' + x] = static_cast<unsigned char>(x + 10);
+        table['a' + x] = static_cast<unsigned char>(x + 10);
+    }
+
+    return table;
+}();
+
+/*******************************************************************************
+* Checks for the whitespace chars which may surround a line
+*******************************************************************************/
+constexpr bool isLineSpace(char value)
+{
+    return value == ' ' || value == '\t' || value == '\r' || value == '\n' ||
+        value == '\v' || value == '\f';
+}
+
+/*******************************************************************************
+* Cuts the next line out of the content without copying it. The returned line
+* is stripped of surrounding whitespace and may be empty.
+*******************************************************************************/
+std::string_view nextLine(std::string_view& content)
+{
+    const auto lineEnd = content.find('\n');
+    auto ihLine = content.substr(0, lineEnd);
+    content.remove_prefix(lineEnd == std::string_view::npos ?
+        content.size() : lineEnd + 1);
+
+    while (!ihLine.empty() && isLineSpace(ihLine.back()))
+    {
+        ihLine.remove_suffix(1);
+    }
+    while (!ihLine.empty() && isLineSpace(ihLine.front()))
+    {
+        ihLine.remove_prefix(1);
+    }
+
+    return ihLine;
+}
+
+/*******************************************************************************
+* Smallest amount of text worth decoding on a thread of its own
+*******************************************************************************/
+constexpr std::size_t MIN_PARALLEL_CHUNK_SIZE = 256 * 1024;
+
+/*******************************************************************************
+* Largest possible record: length, load offset, type, 255 data bytes, checksum
+*******************************************************************************/
+constexpr std::size_t MAX_RECORD_BYTES = 1 + 2 + 1 + 255 + 1;
+
+/*******************************************************************************
+* Converts a record (without its record mark) into bytes and checks it the way
+* decodeRecord() does: chars which aren't HEX digits count as 0, the checksum
+* has to be 0 and the record length has to match the line. Returns false for
+* records decodeRecord() skips.
+*******************************************************************************/
+bool validRecord(std::string_view ihLine,
+    std::array<unsigned char, MAX_RECORD_BYTES>& record)
+{
+    std::size_t noOfBytes = 0;
+    unsigned char intelHexChecksum = 0;
+
+    for (std::size_t position = 0; position + 1 < ihLine.size(); position += 2)
+    {
+        const unsigned char highNibble =
+            hexNibbleTable[static_cast<unsigned char>(ihLine[position])];
+        const unsigned char lowNibble =
+            hexNibbleTable[static_cast<unsigned char>(ihLine[position + 1])];
+        const unsigned char byteRead = (highNibble | lowNibble) == INVALID_NIBBLE ?
+            0 : static_cast<unsigned char>((highNibble << 4) | lowNibble);
+
+        intelHexChecksum += byteRead;
+
+        if (noOfBytes < record.size())
+        {
+            record[noOfBytes] = byteRead;
+        }
+        ++noOfBytes;
+    }
+
+    return intelHexChecksum == 0 && noOfBytes >= 5 &&
+        noOfBytes == static_cast<std::size_t>(record[0]) + 5;
+}
+
 /*******************************************************************************
 * Converts a 2 char string to its HEX value
 *******************************************************************************/
@@ -250,47 +360,34 @@ void intelhex::addError(std::string errorMessage)
 }
 
 /*******************************************************************************
-* Decodes a data record read in from a file
+* Inserts decoded data into the content, noting any overlapping bytes
 *******************************************************************************/
-void intelhex::decodeDataRecord(unsigned char recordLength,
-    unsigned long loadOffset,
-    std::string::const_iterator data)
+void intelhex::insertRecordData(unsigned long address,
+    std::span<const std::byte> data)
 {
-    /* Variable to store a byte of the record as a two char string            */
-    std::string sByteRead;
-
-    /* Variable to store the byte of the record as an u.char                  */
-    unsigned char byteRead;
-
-    /* Calculate new SBA by clearing the low four bytes and then adding the   */
-    /* current loadOffset for this line of Intel HEX data                     */
-    segmentBaseAddress &= ~(0xFFFFUL);
-    segmentBaseAddress += loadOffset;
-
-    for (unsigned char x = 0; x < recordLength; x++)
+    /* Data which lies behind everything decoded so far can't overlap any    */
+    /* existing data, so it is appended in one go                            */
+    if (ihContent.append(address, data))
     {
-        sByteRead.erase();
-
-        sByteRead = *data;
-        data++;
-        sByteRead += *data;
-        data++;
+        return;
+    }
 
-        byteRead = stringToHex(sByteRead);
+    for (const auto value : data)
+    {
+        const unsigned char byteRead = static_cast<unsigned char>(value);
 
-        ihReturn = ihContent.insert(
-            std::pair<unsigned long, unsigned char>(segmentBaseAddress, byteRead));
+        const auto result = ihContent.insert(address, value);
 
-        if (ihReturn.second == false)
+        if (result != firmware::reader::SparseImage::InsertResult::Inserted)
         {
             /* If this address already contains the byte we are trying to     */
             /* write, this is only a warning                                  */
-            if (ihReturn.first->second == byteRead)
+            if (result == firmware::reader::SparseImage::InsertResult::Duplicate)
             {
                 std::string message;
 
-                message = "Location 0x" + ulToHexString(segmentBaseAddress) +
-                    " already contains data 0x" + sByteRead;
+                message = "Location 0x" + ulToHexString(address) +
+                    " already contains data 0x" + ucToHexString(byteRead);
 
                 addWarning(message);
             }
@@ -299,543 +396,704 @@ void intelhex::decodeDataRecord(unsigned char recordLength,
             {
                 std::string message;
 
-                message = "Couldn't add 0x" + sByteRead + " @ 0x" +
-                    ulToHexString(segmentBaseAddress) +
+                message = "Couldn't add 0x" + ucToHexString(byteRead) + " @ 0x" +
+                    ulToHexString(address) +
                     "; already contains 0x" +
-                    ucToHexString(ihReturn.first->second);
+                    ucToHexString(static_cast<unsigned char>(
+                        *ihContent.at(address)));
 
                 addError(message);
             }
         }
 
-        /* Increment the segment base address                                 */
-        ++segmentBaseAddress;
+        /* Increment the address                                              */
+        ++address;
     }
 }
 
 /*******************************************************************************
-* Input Stream for Intel HEX File Decoding (friend function)
+* Decodes a data record read in from a file
 *******************************************************************************/
-std::istream& operator>>(std::istream& dataIn, intelhex& ihLocal)
+void intelhex::decodeDataRecord(unsigned char recordLength,
+    unsigned long loadOffset,
+    const unsigned char* data)
 {
-    // Create a string to store lines of Intel Hex info
-    std::string ihLine;
-    /* Create a string to store a single byte of Intel HEX info               */
-    std::string ihByte;
-    // Create an iterator for this variable
-    std::string::iterator ihLineIterator;
-    // Create a line counter
-    unsigned long lineCounter = 0;
+    /* Calculate new SBA by clearing the low four bytes and then adding the   */
+    /* current loadOffset for this line of Intel HEX data                     */
+    segmentBaseAddress &= ~(0xFFFFUL);
+    segmentBaseAddress += loadOffset;
+
+    insertRecordData(segmentBaseAddress,
+        std::span<const std::byte>{ reinterpret_cast<const std::byte*>(data),
+                                    recordLength });
+
+    /* Increment the segment base address past the record                     */
+    segmentBaseAddress += recordLength;
+}
+
+/*******************************************************************************
+* Decodes a single line of an Intel HEX file
+*******************************************************************************/
+bool intelhex::decodeRecord(std::string_view ihLine, unsigned long lineCounter)
+{
+    // Decoded bytes of the record; no record can be longer than this
+    std::array<unsigned char, MAX_RECORD_BYTES> record;
+    // Number of bytes decoded from the line
+    std::size_t noOfBytes = 0;
     // Variable to hold a single byte (two chars) of data
-    unsigned char byteRead;
+    unsigned char byteRead = 0;
     // Variable to calculate the checksum for each line
-    unsigned char intelHexChecksum;
-    // Variable to hold the record length
-    unsigned char recordLength;
-    // Variable to hold the load offset
-    unsigned long loadOffset;
-    // Variables to hold the record type
-    intelhexRecordType recordType;
-
-    do
+    unsigned char intelHexChecksum = 0;
+
+    /* Strip surrounding whitespace, e.g. the '\r' of DOS line endings       */
+    while (!ihLine.empty() && isLineSpace(ihLine.front()))
+    {
+        ihLine.remove_prefix(1);
+    }
+    while (!ihLine.empty() && isLineSpace(ihLine.back()))
     {
-        /* Clear the string before this next round                            */
-        ihLine.erase();
+        ihLine.remove_suffix(1);
+    }
 
-        /* Clear the checksum before processing this line                     */
-        intelHexChecksum = 0;
+    if (ihLine.empty())
+    {
+        return true;
+    }
 
-        /* Get a line of data                                                 */
-        dataIn >> ihLine;
+    /* Check that we have a ':' record mark at the beginning                  */
+    if (ihLine.front() != ':')
+    {
+        /* Add some warning code here                                         */
+        std::string message;
 
-        /* If the line contained some data, process it                        */
-        if (ihLine.length() > 0)
+        message = "Line without record mark ':' found @ line " +
+            ulToString(lineCounter);
+
+        addWarning(message);
+
+        /* If this is the first line, let's simply give up. Chances are this  */
+        /* is not an Intel HEX file at all                                    */
+        if (lineCounter == 1)
         {
-            /* Increment line counter                                         */
-            lineCounter++;
+            message = "Intel HEX File decode aborted; ':' missing in " \
+                "first line.";
+            addError(message);
 
-            /* Set string iterator to start of string                         */
-            ihLineIterator = ihLine.begin();
+            return false;
+        }
+    }
+    else
+    {
+        /* Skip the record mark as we don't need it anymore                   */
+        ihLine.remove_prefix(1);
+    }
 
-            /* Check that we have a ':' record mark at the beginning          */
-            if (*ihLineIterator != ':')
-            {
-                /* Add some warning code here                                 */
-                std::string message;
+    /* Run through the whole line once, converting each pair of chars into a */
+    /* byte and adding it to the checksum. By adding all the bytes in a line */
+    /* together *including* the checksum byte, we should get a result of '0' */
+    /* at the end. If not, there is a checksum error                         */
+    std::size_t position = 0;
+    for (; position + 1 < ihLine.size(); position += 2)
+    {
+        const unsigned char highNibble =
+            hexNibbleTable[static_cast<unsigned char>(ihLine[position])];
+        const unsigned char lowNibble =
+            hexNibbleTable[static_cast<unsigned char>(ihLine[position + 1])];
 
-                message = "Line without record mark ':' found @ line " +
-                    ihLocal.ulToString(lineCounter);
+        if ((highNibble | lowNibble) == INVALID_NIBBLE)
+        {
+            /* Error occured - non-HEX value found                            */
+            std::string message;
 
-                ihLocal.addWarning(message);
+            message = "Can't convert byte 0x" +
+                std::string(ihLine.substr(position, 2)) + " @ 0x" +
+                ulToHexString(segmentBaseAddress) + " to hex.";
 
-                /* If this is the first line, let's simply give up. Chances   */
-                /* are this is not an Intel HEX file at all                   */
-                if (lineCounter == 1)
-                {
-                    message = "Intel HEX File decode aborted; ':' missing in " \
-                        "first line.";
-                    ihLocal.addError(message);
+            addError(message);
 
-                    /* Erase ihLine content and break out of do...while loop  */
-                    ihLine.erase();
-                    break;
-                }
+            byteRead = 0;
+        }
+        else
+        {
+            byteRead = static_cast<unsigned char>((highNibble << 4) | lowNibble);
+        }
+
+        intelHexChecksum += byteRead;
+
+        if (noOfBytes < record.size())
+        {
+            record[noOfBytes] = byteRead;
+        }
+        ++noOfBytes;
+    }
+
+    /* Just in case there are an odd number of chars in the line             */
+    if (position != ihLine.size())
+    {
+        std::string message;
+
+        message = "Odd number of characters in line " +
+            ulToString(lineCounter);
+
+        addError(message);
+    }
+
+    /* Make sure the checksum was ok                                          */
+    if (intelHexChecksum != 0)
+    {
+        /* Note that the checksum contained an error                          */
+        std::string message;
+
+        message = "Checksum error @ line " +
+            ulToString(lineCounter) +
+            "; calculated 0x" +
+            ucToHexString(static_cast<unsigned char>(intelHexChecksum - byteRead)) +
+            " expected 0x" +
+            ucToHexString(byteRead);
+
+        addError(message);
+
+        return true;
+    }
+
+    /* A record consists of length, load offset, type, data and checksum     */
+    if (noOfBytes < 5 || noOfBytes != static_cast<std::size_t>(record[0]) + 5)
+    {
+        std::string message;
+
+        message = "Record length doesn't match line length @ line " +
+            ulToString(lineCounter);
+
+        addError(message);
+
+        return true;
+    }
+
+    /* Get the record length                                                  */
+    const unsigned char recordLength = record[0];
+
+    /* Get the load offset (2 bytes)                                          */
+    const unsigned long loadOffset =
+        (static_cast<unsigned long>(record[1]) << 8) +
+        static_cast<unsigned long>(record[2]);
+
+    /* Get the record type                                                    */
+    const intelhexRecordType recordType =
+        static_cast<intelhexRecordType>(record[3]);
+
+    /* The INFO or DATA portion of the record                                 */
+    const unsigned char* data = &record[4];
+
+    /* Decode the INFO or DATA portion of the record                          */
+    switch (recordType)
+    {
+    case DATA_RECORD:
+        decodeDataRecord(recordLength, loadOffset, data);
+        if (verbose == true)
+        {
+            std::cout << "Data Record begining @ 0x" <<
+                ulToHexString(loadOffset) << std::endl;
+        }
+        break;
+
+    case END_OF_FILE_RECORD:
+        /* Check that the EOF record wasn't already found. If it was,        */
+        /* generate appropriate error                                         */
+        if (foundEof == false)
+        {
+            foundEof = true;
+        }
+        else
+        {
+            std::string message;
+
+            message = "Additional End Of File record @ line " +
+                ulToString(lineCounter) +
+                " found.";
+
+            addError(message);
+        }
+        /* Generate error if there were                                       */
+        if (verbose == true)
+        {
+            std::cout << "End of File" << std::endl;
+        }
+        break;
+
+    case EXTENDED_SEGMENT_ADDRESS:
+        /* Make sure we have 2 bytes of data                                  */
+        if (recordLength == 2)
+        {
+            /* Extract the two bytes of the ESA                               */
+            unsigned long extSegAddress =
+                (static_cast<unsigned long>(data[0]) << 8) +
+                static_cast<unsigned long>(data[1]);
+
+            /* ESA is bits 4-19 of the segment base address (SBA), so shift  */
+            /* left 4 bits                                                    */
+            extSegAddress <<= 4;
+
+            /* Update the SBA                                                 */
+            segmentBaseAddress = extSegAddress;
+        }
+        else
+        {
+            /* Note the error                                                 */
+            std::string message;
+
+            message = "Extended Segment Address @ line " +
+                ulToString(lineCounter) +
+                " not 2 bytes as required.";
+
+            addError(message);
+        }
+        if (verbose == true)
+        {
+            std::cout << "Ext. Seg. Address found: 0x" <<
+                ulToHexString(segmentBaseAddress)
+                << std::endl;
+        }
+
+        break;
+
+    case START_SEGMENT_ADDRESS:
+        /* Make sure we have 4 bytes of data, and that no Start Segment      */
+        /* Address has been found to date                                     */
+        if (recordLength == 4 &&
+            startSegmentAddress.exists == false)
+        {
+            /* Note that the Start Segment Address has been found.            */
+            startSegmentAddress.exists = true;
+
+            startSegmentAddress.csRegister = static_cast<unsigned short>(
+                (data[0] << 8) + data[1]);
+            startSegmentAddress.ipRegister = static_cast<unsigned short>(
+                (data[2] << 8) + data[3]);
+        }
+        /* Note an error if the start seg. address already exists             */
+        else if (startSegmentAddress.exists == true)
+        {
+            std::string message;
+
+            message = "Start Segment Address record appears again @ line " +
+                ulToString(lineCounter) +
+                "; repeated record ignored.";
+
+            addError(message);
+        }
+        /* Note an error if the start lin. address already exists as they     */
+        /* should be mutually exclusive                                       */
+        if (startLinearAddress.exists == true)
+        {
+            std::string message;
+
+            message = "Start Segment Address record found @ line " +
+                ulToString(lineCounter) +
+                " but Start Linear Address already exists.";
+
+            addError(message);
+        }
+        /* Note an error if the record lenght is not 4 as expected            */
+        if (recordLength != 4)
+        {
+            std::string message;
+
+            message = "Start Segment Address @ line " +
+                ulToString(lineCounter) +
+                " not 4 bytes as required.";
+
+            addError(message);
+        }
+        if (verbose == true)
+        {
+            std::cout << "Start Seg. Address - CS 0x" <<
+                ulToHexString(startSegmentAddress.csRegister) <<
+                " IP 0x" <<
+                ulToHexString(startSegmentAddress.ipRegister)
+                << std::endl;
+        }
+        break;
+
+    case EXTENDED_LINEAR_ADDRESS:
+        /* Make sure we have 2 bytes of data                                  */
+        if (recordLength == 2)
+        {
+            /* Extract the two bytes of the ELA                               */
+            unsigned long extLinAddress =
+                (static_cast<unsigned long>(data[0]) << 8) +
+                static_cast<unsigned long>(data[1]);
+
+            /* ELA is bits 16-31 of the segment base address (SBA), so shift */
+            /* left 16 bits                                                   */
+            extLinAddress <<= 16;
+
+            /* Update the SBA                                                 */
+            segmentBaseAddress = extLinAddress;
+        }
+        else
+        {
+            /* Note the error                                                 */
+            std::string message;
+
+            message = "Extended Linear Address @ line " +
+                ulToString(lineCounter) +
+                " not 2 bytes as required.";
+
+            addError(message);
+        }
+        if (verbose == true)
+        {
+            std::cout << "Ext. Lin. Address 0x" <<
+                ulToHexString(segmentBaseAddress)
+                << std::endl;
+        }
+
+        break;
+
+    case START_LINEAR_ADDRESS:
+        /* Make sure we have 4 bytes of data                                  */
+        if (recordLength == 4 &&
+            startLinearAddress.exists == false)
+        {
+            /* Note that the linear start address has been found              */
+            startLinearAddress.exists = true;
+
+            /* Extract the four bytes of the SLA                              */
+            startLinearAddress.eipRegister =
+                (static_cast<unsigned long>(data[0]) << 24) +
+                (static_cast<unsigned long>(data[1]) << 16) +
+                (static_cast<unsigned long>(data[2]) << 8) +
+                static_cast<unsigned long>(data[3]);
+        }
+        /* Note an error if the start seg. address already exists             */
+        else if (startLinearAddress.exists == true)
+        {
+            std::string message;
+
+            message = "Start Linear Address record appears again @ line " +
+                ulToString(lineCounter) +
+                "; repeated record ignored.";
+
+            addError(message);
+        }
+        /* Note an error if the start seg. address already exists as they     */
+        /* should be mutually exclusive                                       */
+        if (startSegmentAddress.exists == true)
+        {
+            std::string message;
+
+            message = "Start Linear Address record found @ line " +
+                ulToString(lineCounter) +
+                " but Start Segment Address already exists.";
+
+            addError(message);
+        }
+        /* Note an error if the record lenght is not 4 as expected            */
+        if (recordLength != 4)
+        {
+            std::string message;
+
+            message = "Start Linear Address @ line " +
+                ulToString(lineCounter) +
+                " not 4 bytes as required.";
+
+            addError(message);
+        }
+        if (verbose == true)
+        {
+            std::cout << "Start Lin. Address - EIP 0x" <<
+                ulToHexString(startLinearAddress.eipRegister)
+                << std::endl;
+        }
+        break;
+
+    default:
+        /* Handle the error here                                              */
+        if (verbose == true)
+        {
+            std::cout << "Unknown Record @ line " <<
+                ulToString(lineCounter) << std::endl;
+        }
+
+
+        std::string message;
+
+        message = "Unknown Intel HEX record @ line " +
+            ulToString(lineCounter);
+
+        addError(message);
+
+        break;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Decodes all lines of a buffer, continuing from the given line number
+*******************************************************************************/
+unsigned long intelhex::decodeLines(std::string_view content,
+    unsigned long lineCounter)
+{
+    while (!content.empty())
+    {
+        const auto ihLine = nextLine(content);
+
+        /* Blank lines are skipped, just like the stream operator does        */
+        if (ihLine.empty())
+        {
+            continue;
+        }
+
+        /* Increment line counter                                             */
+        lineCounter++;
+
+        if (!decodeRecord(ihLine, lineCounter))
+        {
+            break;
+        }
+    }
+
+    return lineCounter;
+}
+
+/*******************************************************************************
+* Decodes a whole Intel HEX file held in memory
+*******************************************************************************/
+void intelhex::decode(std::string_view content)
+{
+    const auto lineCounter = decodeLines(content, 0);
+
+    ihContent.coalesce();
+
+    if (verbose == true)
+    {
+        std::cout << "Decoded " << lineCounter << " lines from file." << std::endl;
+    }
+}
+
+/*******************************************************************************
+* Decodes a whole Intel HEX file held in memory using several threads
+*******************************************************************************/
+void intelhex::decode(std::string_view content, unsigned int threads)
+{
+    /* Decoder state at the start of a chunk of lines                         */
+    struct ChunkState
+    {
+        std::string_view content;
+        unsigned long lineCounter;
+        unsigned long segmentBaseAddress;
+        bool foundEof;
+        bool startSegmentExists;
+        bool startLinearExists;
+    };
+
+    /* Every chunk has to be large enough to be worth a thread of its own     */
+    const std::size_t noOfChunks = std::min<std::size_t>(threads,
+        content.size() / MIN_PARALLEL_CHUNK_SIZE);
+
+    /* Files which don't start with a record mark are aborted right away by  */
+    /* the sequential decoder, so leave them to it                            */
+    std::string_view firstLine;
+    for (auto remaining = content; firstLine.empty() && !remaining.empty(); )
+    {
+        firstLine = nextLine(remaining);
+    }
+
+    if (noOfChunks < 2 || firstLine.empty() || firstLine.front() != ':')
+    {
+        decode(content);
+        return;
+    }
+
+    /* Split the content at the first line boundary behind each multiple of  */
+    /* the chunk size                                                         */
+    std::vector<std::size_t> boundaries{ 0 };
+    for (std::size_t x = 1; x < noOfChunks; x++)
+    {
+        const auto lineEnd = content.find('\n', x * (content.size() / noOfChunks));
+        if (lineEnd == std::string_view::npos)
+        {
+            break;
+        }
+        if (lineEnd + 1 > boundaries.back() && lineEnd + 1 < content.size())
+        {
+            boundaries.push_back(lineEnd + 1);
+        }
+    }
+    boundaries.push_back(content.size());
+
+    /* Pre-scan the records to know the decoder state at the start of every  */
+    /* chunk. Only the address records, the length of the data records and   */
+    /* the EOF/start address records influence that state. Records are       */
+    /* validated like decodeRecord() does, a damaged address record must not */
+    /* move the following chunks                                              */
+    std::vector<ChunkState> chunks;
+    ChunkState state{ {}, 0, segmentBaseAddress, foundEof,
+        startSegmentAddress.exists, startLinearAddress.exists };
+    std::array<unsigned char, MAX_RECORD_BYTES> record;
+    for (std::size_t x = 0; x + 1 < boundaries.size(); x++)
+    {
+        state.content = content.substr(boundaries[x],
+            boundaries[x + 1] - boundaries[x]);
+        chunks.push_back(state);
+
+        for (auto remaining = state.content; !remaining.empty(); )
+        {
+            auto ihLine = nextLine(remaining);
+
+            if (ihLine.empty())
+            {
+                continue;
             }
-            else
+
+            state.lineCounter++;
+
+            if (ihLine.front() == ':')
             {
-                /* Remove the record mark from the string as we don't need it */
-                /* anymore                                                    */
-                ihLine.erase(ihLineIterator);
+                ihLine.remove_prefix(1);
             }
 
-            /* Run through the whole line to check the checksum               */
-            for (ihLineIterator = ihLine.begin();
-                ihLineIterator != ihLine.end();
-                /* Nothing - really! */)
+            if (!validRecord(ihLine, record))
             {
-                /* Convert the line in pair of chars (making a single byte)   */
-                /* into single bytes, and then add to the checksum variable.  */
-                /* By adding all the bytes in a line together *including* the */
-                /* checksum byte, we should get a result of '0' at the end.   */
-                /* If not, there is a checksum error                          */
-                ihByte.erase();
-
-                ihByte = *ihLineIterator;
-                ++ihLineIterator;
-                /* Just in case there are an odd number of chars in the       */
-                /* just check we didn't reach the end of the string early     */
-                if (ihLineIterator != ihLine.end())
-                {
-                    ihByte += *ihLineIterator;
-                    ++ihLineIterator;
+                continue;
+            }
 
-                    byteRead = ihLocal.stringToHex(ihByte);
+            const unsigned long recordLength = record[0];
+            const unsigned long loadOffset =
+                (static_cast<unsigned long>(record[1]) << 8) + record[2];
+            const unsigned long recordType = record[3];
 
-                    intelHexChecksum += byteRead;
-                }
-                else
-                {
-                    std::string message;
+            switch (recordType)
+            {
+            case DATA_RECORD:
+                state.segmentBaseAddress &= ~(0xFFFFUL);
+                state.segmentBaseAddress += loadOffset + recordLength;
+                break;
 
-                    message = "Odd number of characters in line " +
-                        ihLocal.ulToString(lineCounter);
+            case END_OF_FILE_RECORD:
+                state.foundEof = true;
+                break;
 
-                    ihLocal.addError(message);
+            case EXTENDED_SEGMENT_ADDRESS:
+            case EXTENDED_LINEAR_ADDRESS:
+            {
+                const unsigned long address =
+                    (static_cast<unsigned long>(record[4]) << 8) + record[5];
+                if (recordLength == 2)
+                {
+                    state.segmentBaseAddress = address <<
+                        (recordType == EXTENDED_SEGMENT_ADDRESS ? 4 : 16);
                 }
+                break;
             }
 
-            /* Make sure the checksum was ok                                  */
-            if (intelHexChecksum == 0)
-            {
-                /* Reset iterator back to beginning of the line so we can now */
-                /* decode it                                                  */
-                ihLineIterator = ihLine.begin();
-
-                /* Clear all the variables associated with decoding a line of */
-                /* Intel HEX code.                                            */
-                recordLength = 0;
-                loadOffset = 0;
-
-                /* Get the record length                                      */
-                ihByte.erase();
-                ihByte = *ihLineIterator;
-                ++ihLineIterator;
-                ihByte += *ihLineIterator;
-                ++ihLineIterator;
-                recordLength = ihLocal.stringToHex(ihByte);
-
-                /* Get the load offset (2 bytes)                              */
-                ihByte.erase();
-                ihByte = *ihLineIterator;
-                ++ihLineIterator;
-                ihByte += *ihLineIterator;
-                ++ihLineIterator;
-                loadOffset =
-                    static_cast<unsigned long>(ihLocal.stringToHex(ihByte));
-                loadOffset <<= 8;
-                ihByte.erase();
-                ihByte = *ihLineIterator;
-                ++ihLineIterator;
-                ihByte += *ihLineIterator;
-                ++ihLineIterator;
-                loadOffset +=
-                    static_cast<unsigned long>(ihLocal.stringToHex(ihByte));
-
-                /* Get the record type                                        */
-                ihByte.erase();
-                ihByte = *ihLineIterator;
-                ++ihLineIterator;
-                ihByte += *ihLineIterator;
-                ++ihLineIterator;
-                recordType =
-                    static_cast<intelhexRecordType>(ihLocal.stringToHex(ihByte));
-
-                /* Decode the INFO or DATA portion of the record              */
-                switch (recordType)
-                {
-                case DATA_RECORD:
-                    ihLocal.decodeDataRecord(recordLength, loadOffset,
-                        ihLineIterator);
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "Data Record begining @ 0x" <<
-                            ihLocal.ulToHexString(loadOffset) << std::endl;
-                    }
-                    break;
+            case START_SEGMENT_ADDRESS:
+                state.startSegmentExists = state.startSegmentExists ||
+                    recordLength == 4;
+                break;
 
-                case END_OF_FILE_RECORD:
-                    /* Check that the EOF record wasn't already found. If */
-                    /* it was, generate appropriate error                 */
-                    if (ihLocal.foundEof == false)
-                    {
-                        ihLocal.foundEof = true;
-                    }
-                    else
-                    {
-                        std::string message;
-
-                        message = "Additional End Of File record @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " found.";
-
-                        ihLocal.addError(message);
-                    }
-                    /* Generate error if there were                       */
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "End of File" << std::endl;
-                    }
-                    break;
+            case START_LINEAR_ADDRESS:
+                state.startLinearExists = state.startLinearExists ||
+                    recordLength == 4;
+                break;
 
-                case EXTENDED_SEGMENT_ADDRESS:
-                    /* Make sure we have 2 bytes of data                  */
-                    if (recordLength == 2)
-                    {
-                        /* Extract the two bytes of the ESA               */
-                        unsigned long extSegAddress = 0;
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        extSegAddress = static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        extSegAddress <<= 8;
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        extSegAddress += static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-
-                        /* ESA is bits 4-19 of the segment base address   */
-                        /* (SBA), so shift left 4 bits                    */
-                        extSegAddress <<= 4;
-
-                        /* Update the SBA                                 */
-                        ihLocal.segmentBaseAddress = extSegAddress;
-                    }
-                    else
-                    {
-                        /* Note the error                                 */
-                        std::string message;
-
-                        message = "Extended Segment Address @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " not 2 bytes as required.";
-
-                        ihLocal.addError(message);
-                    }
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "Ext. Seg. Address found: 0x" <<
-                            ihLocal.ulToHexString(ihLocal.segmentBaseAddress)
-                            << std::endl;
-                    }
+            default:
+                break;
+            }
+        }
+    }
 
-                    break;
+    /* Decode every chunk into a decoder of its own                           */
+    std::vector<intelhex> decoders(chunks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size());
 
-                case START_SEGMENT_ADDRESS:
-                    /* Make sure we have 4 bytes of data, and that no     */
-                    /* Start Segment Address has been found to date       */
-                    if (recordLength == 4 &&
-                        ihLocal.startSegmentAddress.exists == false)
-                    {
-                        /* Note that the Start Segment Address has been   */
-                        /* found.                                         */
-                        ihLocal.startSegmentAddress.exists = true;
-                        /* Clear the two registers, just in case          */
-                        ihLocal.startSegmentAddress.csRegister = 0;
-                        ihLocal.startSegmentAddress.ipRegister = 0;
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startSegmentAddress.csRegister =
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        ihLocal.startSegmentAddress.csRegister <<= 8;
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startSegmentAddress.csRegister +=
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startSegmentAddress.ipRegister =
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        ihLocal.startSegmentAddress.ipRegister <<= 8;
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startSegmentAddress.ipRegister +=
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                    }
-                    /* Note an error if the start seg. address already    */
-                    /* exists                                             */
-                    else if (ihLocal.startSegmentAddress.exists == true)
-                    {
-                        std::string message;
-
-                        message = "Start Segment Address record appears again @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            "; repeated record ignored.";
-
-                        ihLocal.addError(message);
-                    }
-                    /* Note an error if the start lin. address already    */
-                    /* exists as they should be mutually exclusive        */
-                    if (ihLocal.startLinearAddress.exists == true)
-                    {
-                        std::string message;
-
-                        message = "Start Segment Address record found @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " but Start Linear Address already exists.";
-
-                        ihLocal.addError(message);
-                    }
-                    /* Note an error if the record lenght is not 4 as     */
-                    /* expected                                           */
-                    if (recordLength != 4)
-                    {
-                        std::string message;
-
-                        message = "Start Segment Address @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " not 4 bytes as required.";
-
-                        ihLocal.addError(message);
-                    }
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "Start Seg. Address - CS 0x" <<
-                            ihLocal.ulToHexString(ihLocal.startSegmentAddress.csRegister) <<
-                            " IP 0x" <<
-                            ihLocal.ulToHexString(ihLocal.startSegmentAddress.ipRegister)
-                            << std::endl;
-                    }
-                    break;
+    for (std::size_t x = 0; x < chunks.size(); x++)
+    {
+        auto& decoder = decoders[x];
+        decoder.segmentBaseAddress = chunks[x].segmentBaseAddress;
+        decoder.foundEof = chunks[x].foundEof;
+        decoder.startSegmentAddress.exists = chunks[x].startSegmentExists;
+        decoder.startLinearAddress.exists = chunks[x].startLinearExists;
 
-                case EXTENDED_LINEAR_ADDRESS:
-                    /* Make sure we have 2 bytes of data                  */
-                    if (recordLength == 2)
-                    {
-                        /* Extract the two bytes of the ELA               */
-                        unsigned long extLinAddress = 0;
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        extLinAddress = static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        extLinAddress <<= 8;
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        extLinAddress += static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-
-                        /* ELA is bits 16-31 of the segment base address  */
-                        /* (SBA), so shift left 16 bits                   */
-                        extLinAddress <<= 16;
-
-                        /* Update the SBA                                 */
-                        ihLocal.segmentBaseAddress = extLinAddress;
-                    }
-                    else
-                    {
-                        /* Note the error                                 */
-                        //cout << "Error in Ext. Lin. Address" << endl;
-
-                        std::string message;
-
-                        message = "Extended Linear Address @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " not 2 bytes as required.";
-
-                        ihLocal.addError(message);
-                    }
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "Ext. Lin. Address 0x" <<
-                            ihLocal.ulToHexString(ihLocal.segmentBaseAddress)
-                            << std::endl;
-                    }
+        workers.emplace_back([&decoder, &chunk = chunks[x]]()
+        {
+            decoder.decodeLines(chunk.content, chunk.lineCounter);
+        });
+    }
 
-                    break;
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
 
-                case START_LINEAR_ADDRESS:
-                    /* Make sure we have 4 bytes of data                  */
-                    if (recordLength == 4 &&
-                        ihLocal.startLinearAddress.exists == false)
-                    {
-                        /* Note that the linear start address has been    */
-                        /* found                                          */
-                        ihLocal.startLinearAddress.exists = true;
-
-                        /* Clear the EIP register                         */
-                        ihLocal.startLinearAddress.eipRegister = 0;
-
-                        /* Extract the four bytes of the SLA              */
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startLinearAddress.eipRegister =
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        ihLocal.startLinearAddress.eipRegister <<= 8;
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startLinearAddress.eipRegister +=
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        ihLocal.startLinearAddress.eipRegister <<= 8;
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startLinearAddress.eipRegister +=
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-                        ihLocal.startLinearAddress.eipRegister <<= 8;
-
-                        ihByte.erase();
-                        ihByte = *ihLineIterator;
-                        ++ihLineIterator;
-                        ihByte += *ihLineIterator;
-                        ++ihLineIterator;
-                        ihLocal.startLinearAddress.eipRegister +=
-                            static_cast<unsigned long>
-                            (ihLocal.stringToHex(ihByte));
-
-                    }
-                    /* Note an error if the start seg. address already    */
-                    /* exists                                             */
-                    else if (ihLocal.startLinearAddress.exists == true)
-                    {
-                        std::string message;
-
-                        message = "Start Linear Address record appears again @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            "; repeated record ignored.";
-
-                        ihLocal.addError(message);
-                    }
-                    /* Note an error if the start seg. address already    */
-                    /* exists as they should be mutually exclusive        */
-                    if (ihLocal.startSegmentAddress.exists == true)
-                    {
-                        std::string message;
-
-                        message = "Start Linear Address record found @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " but Start Segment Address already exists.";
-
-                        ihLocal.addError(message);
-                    }
-                    /* Note an error if the record lenght is not 4 as     */
-                    /* expected                                           */
-                    if (recordLength != 4)
-                    {
-                        std::string message;
-
-                        message = "Start Linear Address @ line " +
-                            ihLocal.ulToString(lineCounter) +
-                            " not 4 bytes as required.";
-
-                        ihLocal.addError(message);
-                    }
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "Start Lin. Address - EIP 0x" <<
-                            ihLocal.ulToHexString(ihLocal.startLinearAddress.eipRegister)
-                            << std::endl;
-                    }
-                    break;
+    /* Merge the chunks in file order, so earlier records keep precedence    */
+    /* and overlaps between chunks are reported like within a chunk          */
+    for (std::size_t x = 0; x < decoders.size(); x++)
+    {
+        auto& decoder = decoders[x];
 
-                default:
-                    /* Handle the error here                              */
-                    if (ihLocal.verbose == true)
-                    {
-                        std::cout << "Unknown Record @ line " <<
-                            ihLocal.ulToString(lineCounter) << std::endl;
-                    }
+        for (const auto& segment : decoder.ihContent.segments())
+        {
+            insertRecordData(segment.address, segment.data);
+        }
 
+        /* Messages are numbered when they are added, so drop the chunk's    */
+        /* numbering and let addWarning()/addError() renumber them           */
+        for (const auto& message : decoder.msgWarning.ihWarnings)
+        {
+            addWarning(message.substr(message.find(": ") + 2));
+        }
+        for (const auto& message : decoder.msgError.ihErrors)
+        {
+            addError(message.substr(message.find(": ") + 2));
+        }
 
-                    std::string message;
+        if (decoder.startSegmentAddress.exists && !chunks[x].startSegmentExists)
+        {
+            startSegmentAddress = decoder.startSegmentAddress;
+        }
+        if (decoder.startLinearAddress.exists && !chunks[x].startLinearExists)
+        {
+            startLinearAddress = decoder.startLinearAddress;
+        }
+        foundEof = foundEof || decoder.foundEof;
+        segmentBaseAddress = decoder.segmentBaseAddress;
+    }
 
-                    message = "Unknown Intel HEX record @ line " +
-                        ihLocal.ulToString(lineCounter);
+    ihContent.coalesce();
 
-                    ihLocal.addError(message);
+    if (verbose == true)
+    {
+        std::cout << "Decoded " << state.lineCounter << " lines from file in "
+            << decoders.size() << " chunks." << std::endl;
+    }
+}
 
-                    break;
-                }
-            }
-            else
-            {
-                /* Note that the checksum contained an error                  */
-                std::string message;
+/*******************************************************************************
+* Input Stream for Intel HEX File Decoding (friend function)
+*******************************************************************************/
+std::istream& operator>>(std::istream& dataIn, intelhex& ihLocal)
+{
+    // Create a string to store lines of Intel Hex info; its buffer is reused
+    // for every line, so decoding doesn't allocate per line
+    std::string ihLine;
+    // Create a line counter
+    unsigned long lineCounter = 0;
 
-                message = "Checksum error @ line " +
-                    ihLocal.ulToString(lineCounter) +
-                    "; calculated 0x" +
-                    ihLocal.ucToHexString(intelHexChecksum - byteRead) +
-                    " expected 0x" +
-                    ihLocal.ucToHexString(byteRead);
+    while (dataIn >> ihLine)
+    {
+        /* Increment line counter                                             */
+        lineCounter++;
 
-                ihLocal.addError(message);
-            }
+        if (!ihLocal.decodeRecord(ihLine, lineCounter))
+        {
+            break;
         }
-    } while (ihLine.length() > 0);
+    }
+
+    ihLocal.ihContent.coalesce();
 
     if (ihLocal.verbose == true)
     {
@@ -853,7 +1111,7 @@ std::ostream& operator<<(std::ostream& dataOut, intelhex& ihLocal)
     /* Stores the address offset needed by the linear/segment address records */
     unsigned long addressOffset;
     /* Iterator into the ihContent - where the addresses & data are stored    */
-    std::map<unsigned long, unsigned char>::iterator ihIterator;
+    firmware::reader::SparseImage::const_iterator ihIterator;
     /* Holds string that represents next record to be written                 */
     std::string thisRecord;
     /* Checksum calculation variable                                          */
@@ -866,7 +1124,7 @@ std::ostream& operator<<(std::ostream& dataOut, intelhex& ihLocal)
     {
         /* Calculate the Linear/Segment address                               */
         ihIterator = ihLocal.ihContent.begin();
-        addressOffset = (*ihIterator).first;
+        addressOffset = (*ihIterator).address;
         checksum = 0;
 
         /* Construct the first record to define the segment base address      */
@@ -923,7 +1181,7 @@ std::ostream& operator<<(std::ostream& dataOut, intelhex& ihLocal)
         while (ihIterator != ihLocal.ihContent.end())
         {
             /* Check to see if we need to start a new linear/segment section  */
-            loadOffset = (*ihIterator).first;
+            loadOffset = (*ihIterator).address;
 
             /* If we are using the linear mode...                             */
             if (ihLocal.segmentAddressMode == false)
@@ -994,14 +1252,14 @@ std::ostream& operator<<(std::ostream& dataOut, intelhex& ihLocal)
             /* We need to check where the data actually starts, but only the  */
             /* bottom 16-bits; the other bits are in the segment/linear       */
             /* address record                                                 */
-            loadOffset = (*ihIterator).first & 0xFFFF;
+            loadOffset = (*ihIterator).address & 0xFFFF;
 
             /* Loop through and collect up to 16 bytes of data                */
             for (int x = 0; x < 16; x++)
             {
-                currentAddress = (*ihIterator).first & 0xFFFF;
+                currentAddress = (*ihIterator).address & 0xFFFF;
 
-                recordData.push_back((*ihIterator).second);
+                recordData.push_back(static_cast<unsigned char>((*ihIterator).data));
 
                 ihIterator++;
 
@@ -1013,7 +1271,7 @@ std::ostream& operator<<(std::ostream& dataOut, intelhex& ihLocal)
 
                 /* Check that the next address is consecutive                 */
                 previousAddress = currentAddress;
-                currentAddress = (*ihIterator).first & 0xFFFF;
+                currentAddress = (*ihIterator).address & 0xFFFF;
                 if (currentAddress != (previousAddress + 1))
                 {
                     break;
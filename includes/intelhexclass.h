@@ -43,9 +43,10 @@
 *                                 INCLUDE FILES
 *******************************************************************************/
 #include <iostream>
-#include <map>
 #include <list>
+#include <string_view>
 #include <utility>
+#include "../src/loader/SparseImage.h"
 
 /*******************************************************************************
 *                                    EXTERNS
@@ -116,10 +117,10 @@ private:
     /**********************************************************************/
     /*! \brief Container for decoded Intel HEX content.
     *
-    * STL map holding the addresses found in the Intel HEX file and the
-    * associated data byte stored at that address
+    * Sparse image holding the data found in the Intel HEX file as sorted
+    * runs of contiguous bytes, keyed by the address of their first byte
     ***********************************************************************/
-    std::map<unsigned long, unsigned char> ihContent;
+    firmware::reader::SparseImage ihContent;
 
     /**********************************************************************/
     /*! \brief Iterator for the container holding the decoded Intel HEX
@@ -127,20 +128,9 @@ private:
     *
     * This iterator is used by the class to point to the location in memory
     * currently being used to read or write data. If no file has been
-    * loaded into memory, it points to the start of ihContent.
+    * loaded into memory, it points to the end of ihContent.
     ***********************************************************************/
-    std::map<unsigned long, unsigned char>::iterator ihIterator;
-
-    /**********************************************************************/
-    /*! \brief Pair for the container holding the decoded Intel HEX content.
-    *
-    * This is used to acquire the result of an attempt to insert new data
-    * into ihContent. Since the ihContent is a map STL, it can't allow
-    * data to be assigned to the same address more than once. In this way we
-    * can ensure that no address in a file is falsely assigned data more
-    * than once.
-    ***********************************************************************/
-    std::pair<std::map<unsigned long, unsigned char>::iterator, bool> ihReturn;
+    firmware::reader::SparseImage::const_iterator ihIterator;
 
     /**********************************************************************/
     /*! \brief Stores segment base address of Intel HEX file.
@@ -335,21 +325,65 @@ private:
     /**********************************************************************/
     /*! \brief Decodes the data content of a data record.
     *
-    * Takes the data element of a data record in string format, converts
-    * each 2 char element into a single byte and then inserts that byte of
-    * data into the ihContent STL map.
+    * Takes the already decoded data element of a data record and inserts
+    * its bytes into the ihContent sparse image.
     *
-    * \sa encodeDataRecord()
+    * \sa decodeRecord()
     *
     * \param recordLength   - Number of bytes in this record as extracted
     *                         from this line in the Intel HEX file
     * \param loadOffset     - The offset from the segment base address for
     *                         the first byte in this record
-    * \param data           - The data content of the record in a string
+    * \param data           - The decoded data content of the record
     ***********************************************************************/
     void decodeDataRecord(unsigned char recordLength,
         unsigned long loadOffset,
-        std::string::const_iterator data);
+        const unsigned char* data);
+
+    /**********************************************************************/
+    /*! \brief Decodes a single line of an Intel HEX file.
+    *
+    * Converts the line into bytes with a lookup table and checks the
+    * checksum in the same pass, then decodes the resulting record. The
+    * record is held on the stack, so no memory is allocated unless an
+    * error or warning message is generated.
+    *
+    * \param ihLine         - One line of the Intel HEX file
+    * \param lineCounter    - Number of this line, used for messages
+    *
+    * \retval true          - decoding can continue with the next line
+    * \retval false         - decoding has to be aborted
+    ***********************************************************************/
+    bool decodeRecord(std::string_view ihLine, unsigned long lineCounter);
+
+    /**********************************************************************/
+    /*! \brief Decodes every line of a buffer.
+    *
+    * Splits the buffer into lines and hands them to decodeRecord() until
+    * the buffer is exhausted or decoding has to be aborted. Blank lines
+    * are skipped and not counted.
+    *
+    * \param content        - Lines of an Intel HEX file
+    * \param lineCounter    - Number of lines decoded before this buffer
+    *
+    * \retval               - Number of the last line decoded
+    ***********************************************************************/
+    unsigned long decodeLines(std::string_view content,
+        unsigned long lineCounter);
+
+    /**********************************************************************/
+    /*! \brief Inserts decoded bytes into the content.
+    *
+    * Bytes behind the current end of ihContent are appended in one go.
+    * Otherwise every byte is inserted separately; bytes already present
+    * with the same value generate a warning, bytes present with another
+    * value generate an error and are not overwritten.
+    *
+    * \param address        - Address of the first byte
+    * \param data           - Bytes to insert
+    ***********************************************************************/
+    void insertRecordData(unsigned long address,
+        std::span<const std::byte> data);
 
     /**********************************************************************/
     /*! \brief Add a warning message to the warning message list.
@@ -389,7 +423,10 @@ public:
         const const_iterator operator--(int) { const_iterator retval = *this; --(*this); return retval; }
         bool operator==(const_iterator other) const { return mIterator == other.mIterator; }
         bool operator!=(const_iterator other) const { return !(*this == other); }
-        HexData operator*() const { return HexData{ mIterator->first, mIterator->second }; }
+        HexData operator*() const {
+            const auto element = *mIterator;
+            return HexData{ element.address, static_cast<unsigned char>(element.data) };
+        }
     };
 
     const_iterator begin() const
@@ -411,6 +448,37 @@ public:
     {
         return const_iterator{ ihContent.cend() };
     }
+
+    const firmware::reader::SparseImage& image() const
+    {
+        return ihContent;
+    }
+
+    /**********************************************************************/
+    /*! \brief Decodes a whole Intel HEX file held in memory.
+    *
+    * Works like operator>>() but splits the lines directly out of the
+    * given buffer, e.g. a memory mapped file, without copying them.
+    *
+    * \param content    - Complete content of an Intel HEX file
+    ***********************************************************************/
+    void decode(std::string_view content);
+
+    /**********************************************************************/
+    /*! \brief Decodes a whole Intel HEX file held in memory in parallel.
+    *
+    * Splits the buffer at line boundaries into one chunk per thread. A
+    * quick scan of the record headers provides the segment base address
+    * at the start of each chunk, so the chunks can be decoded
+    * independently. The results are merged in file order, giving the
+    * same content and messages as decode(content). Small buffers are
+    * decoded on the calling thread.
+    *
+    * \param content    - Complete content of an Intel HEX file
+    * \param threads    - Maximum number of threads to use
+    ***********************************************************************/
+    void decode(std::string_view content, unsigned int threads);
+
     /**********************************************************************/
     /*! \brief intelhex Class Constructor.
     *
@@ -444,8 +512,7 @@ public:
         segmentAddressMode = false;
         /* Ensure ihContent is cleared and point ihIterator at it         */
         ihContent.clear();
-        ihContent.begin();
-        ihIterator = ihContent.begin();
+        ihIterator = ihContent.end();
     }
 
     /**********************************************************************/
@@ -487,7 +554,7 @@ public:
         segmentAddressMode = ihSource.segmentAddressMode;
         /* Copy HEX file content variables                                */
         ihContent = ihSource.ihContent;
-        ihIterator = ihSource.ihIterator;
+        ihIterator = ihContent.rebind(ihSource.ihIterator);
     }
 
     /**********************************************************************/
@@ -533,7 +600,7 @@ public:
         segmentAddressMode = ihSource.segmentAddressMode;
         /* Copy HEX file content variables                                */
         ihContent = ihSource.ihContent;
-        ihIterator = ihSource.ihIterator;
+        ihIterator = ihContent.rebind(ihSource.ihIterator);
 
         return *this;
     }
@@ -542,7 +609,7 @@ public:
     /*! \brief Overloaded prefix increment operator
     *
     * Overloads the prefix increment operator to move interal iterator to
-    * next entry in the ihContent map
+    * next entry in the ihContent image
     *
     ***********************************************************************/
     intelhex& operator++()
@@ -556,7 +623,7 @@ public:
     /*! \brief Overloaded postfix increment operator
     *
     * Overloads the postfix increment operator to move interal iterator to
-    * next entry in the ihContent map
+    * next entry in the ihContent image
     *
     ***********************************************************************/
     const intelhex operator++(int)
@@ -570,7 +637,7 @@ public:
     /*! \brief Overloaded prefix decrement operator
     *
     * Overloads the prefix decrement operator to move interal iterator to
-    * previous entry in the ihContent map
+    * previous entry in the ihContent image
     *
     ***********************************************************************/
     intelhex& operator--()
@@ -584,7 +651,7 @@ public:
     /*! \brief Overloaded postfix decrement operator
     *
     * Overloads the postfix decrement operator to move interal iterator to
-    * previous entry in the ihContent map
+    * previous entry in the ihContent image
     *
     ***********************************************************************/
     const intelhex operator--(int)
@@ -662,7 +729,7 @@ public:
 
         if (!ihContent.empty())
         {
-            std::map<unsigned long, unsigned char>::iterator it \
+            firmware::reader::SparseImage::const_iterator it \
                 = ihContent.end();
 
             --it;
@@ -708,7 +775,7 @@ public:
 
         if (ihContent.size() != 0)
         {
-            std::map<unsigned long, unsigned char>::iterator it;
+            firmware::reader::SparseImage::const_iterator it;
             it = ihContent.find(address);
             if (it != ihContent.end())
             {
@@ -801,11 +868,11 @@ public:
     unsigned long currentAddress()
     {
         if (ihIterator != ihContent.end()) {
-            return ihIterator->first;
+            return (*ihIterator).address;
         }
         else if (ihIterator != ihContent.begin()) {
             auto tmpIterator = ihIterator;
-            auto returnValue = (--ihIterator)->first + 1;
+            auto returnValue = (*(--ihIterator)).address + 1;
             ihIterator = tmpIterator;
             return returnValue;
         }
@@ -832,10 +899,7 @@ public:
     {
         if (ihContent.size() != 0)
         {
-            std::map<unsigned long, unsigned char>::iterator it;
-
-            it = ihContent.begin();
-            *address = (*it).first;
+            *address = ihContent.startAddress();
             return true;
         }
 
@@ -860,10 +924,7 @@ public:
     {
         if (ihContent.size() != 0)
         {
-            std::map<unsigned long, unsigned char>::reverse_iterator rit;
-
-            rit = ihContent.rbegin();
-            *address = (*rit).first;
+            *address = ihContent.endAddress() - 1;
             return true;
         }
 
@@ -888,7 +949,7 @@ public:
     {
         if (!ihContent.empty() && (ihIterator != ihContent.end()))
         {
-            *data = ihIterator->second;
+            *data = static_cast<unsigned char>((*ihIterator).data);
             return true;
         }
         return false;
@@ -916,7 +977,7 @@ public:
     bool getData(unsigned char* data, unsigned long address)
     {
         bool found = false;
-        std::map<unsigned long, unsigned char>::iterator localIterator;
+        firmware::reader::SparseImage::const_iterator localIterator;
 
         if (!ihContent.empty())
         {
@@ -926,7 +987,7 @@ public:
             {
                 found = true;
                 ihIterator = localIterator;
-                *data = ihIterator->second;
+                *data = static_cast<unsigned char>((*ihIterator).data);
             }
         }
 
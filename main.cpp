@@ -4,6 +4,8 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <algorithm>
 #include <Poco/JSON/ParseHandler.h>
 #include <Poco/Environment.h>
 #include <catch.hpp>
@@ -17,9 +19,15 @@
 #include "src/serial/Serial.h"
 #include "src/units/Byte.h"
 #include "src/json/ConfigManager.h"
+#include "src/json/CompiledConfig.h"
 #include "src/loader/DataSendManager.h"
-#include "src/loader/HexReader.h"
+#include "src/loader/ReaderFactory.h"
+#include "src/loader/MultiPortFlasher.h"
+#include "src/loader/AutoTuner.h"
+#include "src/daemon/FlashDaemon.h"
+#include "src/simulator/SimulatorPort.h"
 #include "src/utils/utils.h"
+#include "src/utils/Trace.h"
 
 [[nodiscard]] int pgmEnd() {
 #if defined(DEBUG_BUILD) && defined(_MSC_VER)
@@ -28,71 +36,346 @@
     return 0;
 }
 
-int main(int argc, const char* argv[]) {
-    using jsonOpts = firmware::json::config::JsonOptions;
+std::unique_ptr<firmware::reader::AbstractReader> loadReader(const Parse& clParser,
+                                                             const firmware::json::config::ResolvedDeviceConfig& config) {
+    const utils::trace::Span span{ "parse firmware", "reader" };
+    const auto format = firmware::reader::formatFromFile(clParser.binary(), config.binaryFormat);
+    std::optional<firmware::reader::ImageCache> imageCache;
+    if (!clParser.cacheDirectory().empty()) {
+        imageCache.emplace(clParser.cacheDirectory());
+    }
+    auto readerPtr = firmware::reader::makeReader(format, clParser.binary(),
+            config.deviceFlashAvailable, *clParser.baseAddress(),
+            imageCache ? &*imageCache : nullptr);
+    if (!readerPtr) {
+        std::cout << "Unknown Format!" << std::endl;
+        return nullptr;
+    }
+    if (!*readerPtr) {
+        std::cout << *readerPtr->errorMessage();
+        return nullptr;
+    }
+    return readerPtr;
+}
+
+int flashPorts(const Parse& clParser, const firmware::json::config::ConfigManager& configManager,
+               const std::vector<std::string>& ports, const firmware::serial::TuningStore& tuning) {
+    const auto& config = *configManager.resolved();
+    // one parsed image for all ports, the reader is handed over to it
+    auto image = firmware::reader::FirmwareImage::freeze(loadReader(clParser, config));
+    if (!image) {
+        return pgmEnd();
+    }
+    const auto waitTime = CustomDataTypes::parseUnit<std::chrono::milliseconds>(clParser.waitTime());
+    firmware::serial::MultiPortFlasher flasher{ std::move(image), [&](const std::string& port) {
+        const auto baud = clParser.baud();
+        const auto tuned = tuning.find(config.deviceID, port);
+        const auto portConfig = tuned ? firmware::serial::withParameters(config, *tuned) : config;
+        return waitTime ? std::make_unique<firmware::serial::DataSendManager>(portConfig, firmware::serial::CommunicationData{ port, baud }, *waitTime)
+                        : std::make_unique<firmware::serial::DataSendManager>(portConfig, firmware::serial::CommunicationData{ port, baud });
+    }};
+    if (clParser.pipelined()) {
+        flasher.enablePipelining();
+    }
+    if (!clParser.manifestDirectory().empty()) {
+        flasher.setManifestDirectory(clParser.manifestDirectory());
+    }
+
+    // the bar shows the slowest board, it bounds the time of the whole station
+    std::mutex progressMutex;
+    std::vector<double> progress(ports.size(), 0.0);
+    std::cout << "Flashing " << ports.size() << " ports" << std::endl;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const auto results = flasher.flash(ports, [&](std::size_t port, double percent) {
+        std::lock_guard lock{ progressMutex };
+        progress[port] = percent;
+        utils::printPercent(*std::min_element(std::begin(progress), std::end(progress)));
+    });
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << std::endl;
+
+    using namespace utils::printable;
+    std::size_t failed = 0;
+    for (const auto& result : results) {
+        std::cout << result.port << ": ";
+        if (result) {
+            std::cout << "OK, " << result.bytes << " bytes in " << result.duration << std::endl;
+        } else {
+            std::cout << "Error: " << *result.error << std::endl;
+            failed++;
+        }
+    }
+    std::cout << results.size() - failed << " / " << results.size() << " ports flashed in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1) << std::endl;
+    return pgmEnd();
+}
+
+int autoTune(const Parse& clParser, const firmware::json::config::ResolvedDeviceConfig& config, const std::string& port,
+             firmware::serial::TuningStore& tuning) {
+    if (!config.serialAckByte) {
+        std::cout << "Auto tuning needs a device config with an ackByte, without acknowledgements a failed burst can't be noticed"
+                     " and the burst delay isn't tuned" << std::endl;
+        return pgmEnd();
+    }
+    auto image = firmware::reader::FirmwareImage::freeze(loadReader(clParser, config));
+    if (!image) {
+        return pgmEnd();
+    }
+    const auto waitTime = CustomDataTypes::parseUnit<std::chrono::milliseconds>(clParser.waitTime());
+    const auto start = tuning.find(config.deviceID, port).value_or(firmware::serial::transferParameters(config));
+    firmware::serial::TuningLimits limits;
+    limits.maxBytesPerBurst = std::max(limits.maxBytesPerBurst, start.bytesPerBurst);
+    limits.maxAckWindow = std::max(limits.maxAckWindow, start.ackWindow);
+
+    using namespace utils::printable;
+    const firmware::serial::AutoTuner tuner{ start, limits };
+    const auto result = tuner.tune([&](const firmware::serial::TransferParameters& parameters) -> std::optional<std::string> {
+        std::cout << "Trying " << parameters << ": " << std::flush;
+        const auto trialConfig = firmware::serial::withParameters(config, parameters);
+        const auto baud = clParser.baud();
+        try {
+            std::optional<firmware::serial::DataSendManager> manager;
+            if (waitTime) {
+                manager.emplace(trialConfig, firmware::serial::CommunicationData{ port, baud }, *waitTime);
+            } else {
+                manager.emplace(trialConfig, firmware::serial::CommunicationData{ port, baud });
+            }
+            if (!manager->isOpen()) {
+                const auto error = manager->errorMessage().value_or("Unable to open " + port);
+                std::cout << error << std::endl;
+                return error;
+            }
+            const auto transfer = firmware::serial::flashImage(*manager, *image, port, std::nullopt, [](double) {});
+            if (transfer) {
+                std::cout << "OK, " << transfer.duration << std::endl;
+            } else {
+                std::cout << *transfer.error << std::endl;
+            }
+            return transfer.error;
+        } catch (std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return e.what();
+        }
+    });
+
+    if (!result.verified) {
+        std::cout << "The device didn't accept the start settings, nothing was tuned" << std::endl;
+        return pgmEnd();
+    }
+    std::cout << "Fastest settings: " << result.parameters << " (" << result.trials.size() << " transfers)" << std::endl;
+    if (!tuning.store(config.deviceID, port, result.parameters)) {
+        std::cout << "Unable to store the tuned settings" << std::endl;
+    }
+    return pgmEnd();
+}
+
+/**
+ * firmware-loader compile-configs [config folder] [output folder]
+ *
+ * The loader only picks up configs compiled to the default output folder,
+ * compiledConfigFolder(config folder).
+ */
+int compileConfigs(int argc, const char* argv[]) {
+    const std::filesystem::path configFolder = argc > 2 ? argv[2] : ConfigFinder::defaultFolder();
+    const std::filesystem::path outputFolder = argc > 3 ? argv[3] : firmware::json::config::compiledConfigFolder(configFolder);
+    const auto report = firmware::json::config::compileConfigs(configFolder, outputFolder);
+    for (const auto& error : report.errors) {
+        std::cout << "Error: " << error << std::endl;
+    }
+    std::cout << "Compiled " << report.compiled << " device configs to " << outputFolder.string() << std::endl;
+    return report.errors.empty() ? 0 : 1;
+}
+
+int simulateBootloader(int argc, const char* argv[]) {
+#ifdef __linux__
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " simulate-bootloader <device config> [baud] [page write time in us] [fifo depth]" << std::endl;
+        return 1;
+    }
+    firmware::json::config::ConfigManager configManager{ std::filesystem::path{ argv[2] } };
+    if (!configManager) {
+        std::cout << "Error: " << *configManager.errorMessage() << std::endl;
+        return 1;
+    }
+    const auto& config = *configManager.resolved();
+    try {
+        const auto baud = argc > 3 ? static_cast<unsigned int>(std::stoul(argv[3])) : static_cast<unsigned int>(config.serialMaxBaudRate);
+        firmware::simulator::TimingModel timing;
+        if (argc > 4) {
+            timing.pageWriteTime = std::chrono::microseconds{ std::stol(argv[4]) };
+        }
+        if (argc > 5) {
+            timing.fifoDepth = std::stoul(argv[5]);
+        }
+
+        firmware::simulator::BootloaderSimulator simulator{ config, baud, timing };
+        firmware::simulator::SimulatorPort port{ simulator };
+        if (!port) {
+            std::cout << "Error: " << *port.errorMessage() << std::endl;
+            return 1;
+        }
+        std::cout << "Simulating " << config.deviceName << " at " << baud << " baud on " << port.devicePath() << std::endl;
+        port.run([](const firmware::simulator::SimulationReport& report) {
+            std::cout << (report ? "Transfer ok" : "Transfer failed") << ": " << report.bytesReceived << " bytes, "
+                      << report.pagesWritten << " pages, " << report.overruns << " overruns";
+            if (report.firstOverrun) {
+                std::cout << " (first at byte " << *report.firstOverrun << ")";
+            }
+            std::cout << ", max latency " << report.maxLatency.count() << "us";
+            if (report.protocolError) {
+                std::cout << ", " << *report.protocolError;
+            } else if (!report.complete) {
+                std::cout << ", incomplete";
+            }
+            std::cout << std::endl;
+        });
+    } catch (std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+#else
+    std::cout << "The bootloader simulator needs pseudo terminals, they are only supported on Linux" << std::endl;
+    return 1;
+#endif
+}
 
+int main(int argc, const char* argv[]) {
+    if (argc > 1 && std::string_view{ argv[1] } == "compile-configs") {
+        return compileConfigs(argc, argv);
+    }
+    if (argc > 1 && std::string_view{ argv[1] } == "simulate-bootloader") {
+        return simulateBootloader(argc, argv);
+    }
     Parse clParser{argc, argv};
     if(!clParser) {
         std::cout << clParser;
         return pgmEnd();
     }
+    std::optional<utils::trace::Recording> trace;
+    if (!clParser.traceFile().empty()) {
+        trace.emplace(clParser.traceFile());
+    }
 
 	using namespace CustomDataTypes::ComputerScience::literals;
     using namespace utils::printable;
 
+    firmware::serial::TuningStore tuning{ clParser.tuningFile().empty() ? std::filesystem::path{ firmware::serial::TuningStore::defaultFile }
+                                                                         : std::filesystem::path{ clParser.tuningFile() } };
+    if (!clParser.daemonSocket().empty()) {
+        // ports are opened like in a single run, the tuning file is read once at the start
+        firmware::daemon::FlashDaemon daemon{ clParser.daemonSocket(),
+            [&clParser, &tuning](const firmware::json::config::ConfigManager& manager, const std::string& port, unsigned int baud) {
+                const auto& config = *manager.resolved();
+                const auto tuned = tuning.find(config.deviceID, port);
+                auto sendManager = std::make_unique<firmware::serial::DataSendManager>(
+                        tuned ? firmware::serial::withParameters(config, *tuned) : config,
+                        firmware::serial::CommunicationData{ port, baud });
+                if (clParser.pipelined()) {
+                    sendManager->enablePipelining();
+                }
+                return sendManager;
+            }};
+        std::cout << "Waiting for jobs on " << clParser.daemonSocket() << std::endl;
+        daemon.run();
+        return pgmEnd();
+    }
+
 
     firmware::json::config::ConfigManager configManager{clParser.device()};
     if (!configManager) {
         std::cout << "Error: " << *configManager.errorMessage() << std::endl;
         return pgmEnd();
     }
-    std::cout << "Device: " << configManager.getJSONValue<jsonOpts::deviceVendor>()
-        << " " << configManager.getJSONValue<jsonOpts::deviceArch>()
-        << " [" << configManager.getJSONValue<jsonOpts::deviceSubArch>()
-        << "]" << ", " << configManager.getJSONValue<jsonOpts::deviceName>()
+    if (!configManager.resolved()) {
+        std::cout << "Error: " << configManager.resolved().error() << std::endl;
+        return pgmEnd();
+    }
+    const auto& config = *configManager.resolved();
+    std::cout << "Device: " << config.deviceVendor
+        << " " << config.deviceArch
+        << " [" << config.deviceSubArch
+        << "]" << ", " << config.deviceName
         << std::endl;
 
-    if (clParser.baud() < configManager.getJSONValue<jsonOpts::serialMinBaudRate>() &&
-        clParser.baud() > configManager.getJSONValue<jsonOpts::serialMaxBaudRate>()) 
+    if (clParser.baud() < config.serialMinBaudRate &&
+        clParser.baud() > config.serialMaxBaudRate) 
     {
         std::cout << "Given Baudrate is not within the allowed min and max\n\r";
-        std::cout << "Allowed Minimum: " << configManager.getJSONValue<jsonOpts::serialMinBaudRate>() << "\n\r";
-        std::cout << "Allowed Maximum: " << configManager.getJSONValue<jsonOpts::serialMaxBaudRate>() << "\n\r";
+        std::cout << "Allowed Minimum: " << config.serialMinBaudRate << "\n\r";
+        std::cout << "Allowed Maximum: " << config.serialMaxBaudRate << "\n\r";
         std::cout << "Given Value: " << clParser.baud();
         return pgmEnd();
     }
 
+    const auto ports = firmware::serial::expandPorts(clParser.port());
+    if (ports.empty()) {
+        std::cout << "No port matches " << clParser.port() << std::endl;
+        return pgmEnd();
+    }
+    if (clParser.autoTune()) {
+        if (ports.size() > 1) {
+            std::cout << "Auto tuning works on a single port" << std::endl;
+            return pgmEnd();
+        }
+        return autoTune(clParser, config, ports.front(), tuning);
+    }
+    if (ports.size() > 1) {
+        return flashPorts(clParser, configManager, ports, tuning);
+    }
+    const auto& port = ports.front();
+
+    auto portConfig = config;
+    if (const auto tuned = tuning.find(config.deviceID, port)) {
+        portConfig = firmware::serial::withParameters(config, *tuned);
+        std::cout << "Using tuned settings: " << *tuned << std::endl;
+    }
     std::optional<firmware::serial::DataSendManager> sendManager;
     if (auto timeVal = CustomDataTypes::parseUnit<std::chrono::milliseconds>(clParser.waitTime())) {
-        sendManager.emplace(configManager, firmware::serial::CommunicationData{ clParser.port(), clParser.baud() }, *timeVal);
+        sendManager.emplace(portConfig, firmware::serial::CommunicationData{ port, clParser.baud() }, *timeVal);
     } else if (sendManager == std::nullopt) {
-        sendManager.emplace(configManager, firmware::serial::CommunicationData{ clParser.port(), clParser.baud() });
+        sendManager.emplace(portConfig, firmware::serial::CommunicationData{ port, clParser.baud() });
     }
 
 	if (!sendManager->isOpen()) {
 		return pgmEnd();
 	} else {
-        std::cout << "Connection to " << clParser.port() << " successful!" << std::endl;
-        if (configManager.getJSONValue<jsonOpts::binaryFormat>() == serial::utils::BinaryFormats::Unknown) {
-            std::cout << "Unknown Format!" << std::endl;
+        std::cout << "Connection to " << port << " successful!" << std::endl;
+        const auto image = firmware::reader::FirmwareImage::freeze(loadReader(clParser, config));
+        if (!image) {
             return pgmEnd();
         }
-		firmware::reader::HexReader reader{ clParser.binary(), configManager.getJSONValue<jsonOpts::deviceFlashAvailable>() };
-		if(!reader) {
-            std::cout << *reader.errorMessage();
-            return pgmEnd();
-		}
+        const auto& reader = *image;
 
-		auto maxAvail = configManager.getJSONValue<jsonOpts::deviceFlashAvailable>();
+		auto maxAvail = config.deviceFlashAvailable;
         std::cout << "Used " << reader.getFileSize() << " / " << maxAvail
 		        << " (" << (static_cast<long double>(reader.getFileSize()) /
 		        static_cast<long double>(static_cast<decltype(reader.getFileSize())>(maxAvail).count())) << "%)" << std::endl;
         std::cout << "Start Address: 0x" << std::hex << reader.getStartAddress() << std::dec << std::endl;
-        auto t1 = std::chrono::high_resolution_clock::now();
-        *sendManager << reader;
-		sendManager->flush();
-        auto t2 = std::chrono::high_resolution_clock::now();
-        std::cout << "Transmission took " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1) << std::endl;
+        std::optional<std::filesystem::path> manifestDirectory;
+        if (!clParser.manifestDirectory().empty()) {
+            if (config.binaryTransfer == serial::utils::TransferModes::Segmented) {
+                manifestDirectory = clParser.manifestDirectory();
+            } else {
+                std::cout << "Delta transfers need a device with segmented transfer, sending the whole image" << std::endl;
+            }
+        }
+
+        if (clParser.pipelined()) {
+            sendManager->enablePipelining();
+        }
+        const auto result = [&]() {
+            const utils::trace::Span span{ "transmission", "transfer" };
+            return firmware::serial::flashImage(*sendManager, reader, port, manifestDirectory,
+                                                [](double percent) { utils::printPercent(percent); });
+        }();
+        std::cout << std::endl;
+        if (!result) {
+            std::cout << "Error: " << *result.error << std::endl;
+            return pgmEnd();
+        }
+        std::cout << "Sent " << result.bytes << " of " << reader.image().size() << " bytes" << std::endl;
+        std::cout << "Transmission took " << result.duration << std::endl;
 	}
 
     return pgmEnd();
@@ -5,7 +5,9 @@
 #pragma once
 #include <clara.hpp>
 #include <optional>
+#include <string>
 #include "../utils/enum_constants.h"
+#include "../utils/utils.h"
 
 class Parse {
 private:
@@ -14,8 +16,16 @@ private:
     std::string comPortLocation;
     std::string binaryLocation;
     std::string mWaitTime;
+    std::string mBaseAddress;
+    std::string mCacheDirectory;
+    std::string mManifestDirectory;
+    std::string mDaemonSocket;
+    std::string mTuningFile;
+    std::string mTraceFile;
     unsigned int baudrate = 9600;
     bool showHelp = false;
+    bool mPipelined = false;
+    bool mAutoTune = false;
     clara::Parser cli;
 public:
     Parse(int argc, const char* argv[]) noexcept {
@@ -31,20 +41,48 @@ public:
                            ("Binary File to Flash to the chip (mandatory)")
                    | clara::Opt(comPortLocation, "port")
                    ["-p"]["--port"]
-                           ("Specify the port which is connected to the device (mandatory)")
+                           ("Specify the port which is connected to the device, a comma separated list or a pattern like /dev/ttyUSB* flashes several devices at once (mandatory)")
                    | clara::Opt(baudrate, "baud")
                    ["-b"]["--baud"]
                            ("Baudrate for communication with the chip (default: " + std::to_string(baudrate) + ")")
                    | clara::Opt(mWaitTime, "waittime")
                    ["-w"]["--start-waittime"]
-                           ("Wait for this timespan to start with the transmission, during this time the program will only sent sync bytes");
+                           ("Wait for this timespan to start with the transmission, during this time the program will only sent sync bytes")
+                   | clara::Opt(mBaseAddress, "address")
+                   ["-a"]["--base-address"]
+                           ("Flash address of the first byte of a raw binary file, decimal or 0x prefixed hex (default: 0)")
+                   | clara::Opt(mCacheDirectory, "directory")
+                   ["--cache-dir"]
+                           ("Keep parsed images in this directory and reuse them while the hex file is unchanged")
+                   | clara::Opt(mPipelined)
+                   ["--async"]
+                           ("Send bursts from a separate thread while the next ones are prepared")
+                   | clara::Opt(mManifestDirectory, "directory")
+                   ["--delta"]
+                           ("Remember flashed pages per device and port in this directory and only send changed pages (segmented transfer only)")
+                   | clara::Opt(mDaemonSocket, "socket")
+                   ["--daemon"]
+                           ("Keep running and accept flash jobs on this local socket, configs, images and ports stay loaded between jobs. Jobs use the tuning file and --async like a single run")
+                   | clara::Opt(mAutoTune)
+                   ["--auto-tune"]
+                           ("Flash repeatedly with larger bursts and ack windows and remember the fastest settings the device acknowledged. Needs an ackByte in the device config, the burst delay of devices without acknowledgements isn't tuned")
+                   | clara::Opt(mTuningFile, "file")
+                   ["--tuning-file"]
+                           ("File with the tuned settings per device and port (default: transfer_tuning.txt)")
+                   | clara::Opt(mTraceFile, "file")
+                   ["--trace"]
+                           ("Write the time spent in every phase of the transfer to this file, in the Chrome trace event format");
 
         auto result = cli.parse( clara::Args( argc, argv ) );
         if(!result) {
             std::cout << result.errorMessage();
             showHelp = true;
         } else {
-            if(binaryLocation.empty() || comPortLocation.empty() || deviceName.empty()) {
+            if(mDaemonSocket.empty() && (binaryLocation.empty() || comPortLocation.empty() || deviceName.empty())) {
+                showHelp = true;
+            }
+            if(!mBaseAddress.empty() && !baseAddress()) {
+                std::cout << "Invalid base address: " << mBaseAddress << std::endl;
                 showHelp = true;
             }
         }
@@ -74,6 +112,41 @@ public:
         return mWaitTime;
     }
 
+    [[nodiscard]] bool pipelined() const noexcept {
+        return mPipelined;
+    }
+
+    [[nodiscard]] std::string manifestDirectory() const noexcept {
+        return mManifestDirectory;
+    }
+
+    [[nodiscard]] std::string daemonSocket() const noexcept {
+        return mDaemonSocket;
+    }
+
+    [[nodiscard]] bool autoTune() const noexcept {
+        return mAutoTune;
+    }
+
+    [[nodiscard]] std::string tuningFile() const noexcept {
+        return mTuningFile;
+    }
+
+    [[nodiscard]] std::string traceFile() const noexcept {
+        return mTraceFile;
+    }
+
+    [[nodiscard]] std::string cacheDirectory() const noexcept {
+        return mCacheDirectory;
+    }
+
+    [[nodiscard]] std::optional<unsigned long> baseAddress() const noexcept {
+        if (mBaseAddress.empty()) {
+            return 0;
+        }
+        return utils::parseAddress(mBaseAddress);
+    }
+
     explicit operator bool() const {
         return !showHelp;
     }
@@ -0,0 +1,387 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <asio.hpp>
+#include "FlashDaemon.h"
+#include "../json/configFinder.h"
+#include "../json/deviceParser.h"
+#include "../loader/MultiPortFlasher.h"
+#include "../loader/ReaderFactory.h"
+
+namespace firmware::daemon {
+    namespace {
+        std::optional<std::string> optionalValue(const parser::DeviceParser& request, const std::string& key) {
+            auto value = request.getJsonAsString(key);
+            if (!value) {
+                return std::nullopt;
+            }
+            return *value;
+        }
+
+        std::string imageKey(const FlashJob& job, const json::config::ResolvedDeviceConfig& config) {
+            // a rewritten file gets a new key, the old entry ages out of the cache
+            std::error_code error;
+            const auto modified = std::filesystem::last_write_time(job.file, error).time_since_epoch().count();
+            const auto size = std::filesystem::file_size(job.file, error);
+            std::stringstream ss;
+            ss << std::filesystem::absolute(job.file).string() << '|' << modified << '|' << size << '|'
+               << job.baseAddress << '|' << config.deviceFlashAvailable.count();
+            return ss.str();
+        }
+
+        std::filesystem::file_time_type modificationTime(const std::filesystem::path& file) {
+            std::error_code error;
+            return std::filesystem::last_write_time(file, error);
+        }
+    }
+
+    FlashDaemon::FlashDaemon(std::filesystem::path socketPath, ConnectFunction connect, std::size_t cachedImages,
+                             std::chrono::milliseconds requestTimeout) :
+            mSocketPath{ std::move(socketPath) },
+            mConnect{ std::move(connect) },
+            mMaxCachedImages{ std::max<std::size_t>(cachedImages, 1) },
+            mRequestTimeout{ requestTimeout } {
+    }
+
+    FlashDaemon::~FlashDaemon() {
+        stop();
+    }
+
+#ifdef ASIO_HAS_LOCAL_SOCKETS
+    bool FlashDaemon::run() {
+        using protocol = asio::local::stream_protocol;
+        asio::io_service service;
+        protocol::acceptor acceptor{ service };
+        asio::error_code error;
+        std::error_code fileError;
+        // a socket file left behind by a previous daemon would block the bind
+        std::filesystem::remove(mSocketPath, fileError);
+        acceptor.open(protocol{}, error);
+        if (!error) {
+            acceptor.bind(protocol::endpoint{ mSocketPath.string() }, error);
+        }
+        if (!error) {
+            // whoever can connect can flash the ports, so only the user of the daemon may.
+            // Nobody can connect before the socket listens
+            std::filesystem::permissions(mSocketPath, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+                                         fileError);
+            error.assign(fileError.value(), asio::error::get_system_category());
+        }
+        if (!error) {
+            acceptor.listen(asio::socket_base::max_connections, error);
+        }
+        if (error) {
+            std::cout << "Unable to listen on " << mSocketPath.string() << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        // every connection has its own service, the timeout of its request is handled in its thread
+        struct Connection {
+            asio::io_service service;
+            protocol::socket socket{ service };
+        };
+
+        while (!mStopping) {
+            auto connection = std::make_shared<Connection>();
+            acceptor.accept(connection->socket, error);
+            if (mStopping) {
+                break;
+            }
+            if (error) {
+                continue;
+            }
+            {
+                std::lock_guard lock{ mConnectionMutex };
+                mConnections++;
+            }
+            auto serve = [this, connection]() mutable {
+                asio::streambuf buffer;
+                bool received = false;
+                // a client which never finishes its request must not keep run() from returning
+                asio::steady_timer timer{ connection->service, mRequestTimeout };
+                asio::async_read_until(connection->socket, buffer, '\n', [&](const auto& readError, std::size_t) {
+                    // a request without the newline counts if the client closed its side, not if it timed out
+                    received = !readError || (readError == asio::error::eof && buffer.size() > 0);
+                    timer.cancel();
+                });
+                timer.async_wait([&](const auto& timerError) {
+                    if (!timerError) {
+                        asio::error_code closeError;
+                        connection->socket.close(closeError);
+                    }
+                });
+                connection->service.run();
+
+                if (received) {
+                    std::istream stream{ &buffer };
+                    std::string request;
+                    std::getline(stream, request);
+                    execute(request, [&connection](const std::string& line) {
+                        asio::error_code writeError;
+                        asio::write(connection->socket, asio::buffer(line + '\n'), writeError);
+                    });
+                }
+                connection.reset();
+                connectionDone();
+            };
+            try {
+                std::thread{ std::move(serve) }.detach();
+            } catch (std::system_error&) {
+                connectionDone();
+            }
+        }
+        {
+            std::unique_lock lock{ mConnectionMutex };
+            mConnectionsDone.wait(lock, [this]() { return mConnections == 0; });
+        }
+        std::filesystem::remove(mSocketPath, fileError);
+        return true;
+    }
+
+    void FlashDaemon::connectionDone() {
+        // notified under the lock, run() may return and destroy the daemon right after
+        std::lock_guard lock{ mConnectionMutex };
+        mConnections--;
+        mConnectionsDone.notify_all();
+    }
+
+    void FlashDaemon::stop() {
+        if (mStopping.exchange(true)) {
+            return;
+        }
+        // wakes up the blocking accept of run()
+        asio::io_service service;
+        asio::local::stream_protocol::socket socket{ service };
+        asio::error_code error;
+        socket.connect(asio::local::stream_protocol::endpoint{ mSocketPath.string() }, error);
+    }
+#else
+    bool FlashDaemon::run() {
+        std::cout << "The daemon needs local socket support" << std::endl;
+        return false;
+    }
+
+    void FlashDaemon::stop() {
+        mStopping = true;
+    }
+#endif
+
+    void FlashDaemon::execute(const std::string& request, const ReplyFunction& reply) {
+        const auto job = parseJob(request);
+        if (!job) {
+            reply("error " + job.error());
+            return;
+        }
+        const auto manager = config(*job);
+        if (!manager) {
+            reply("error " + manager.error());
+            return;
+        }
+        const auto& resolved = *(*manager)->resolved();
+        const auto firmware = image(*job, resolved);
+        if (!firmware) {
+            reply("error " + firmware.error());
+            return;
+        }
+        auto sendManager = acquirePort(*job, *manager);
+        if (!sendManager) {
+            reply("error " + sendManager.error());
+            return;
+        }
+
+        int lastPercent = -1;
+        const auto result = serial::flashImage(**sendManager, **firmware, job->port, job->manifestDirectory,
+                [&reply, &lastPercent](double percent) {
+                    if (static_cast<int>(percent) != lastPercent) {
+                        lastPercent = static_cast<int>(percent);
+                        reply("progress " + std::to_string(lastPercent));
+                    }
+                });
+        if (result) {
+            releasePort(*job, *manager, std::move(*sendManager));
+            reply("ok " + std::to_string(result.bytes) + " " + std::to_string(result.duration.count()));
+        } else {
+            // the state of the device is unknown, the next job opens the port again
+            releasePort(*job, *manager, nullptr);
+            reply("error " + *result.error);
+        }
+    }
+
+    utils::expected<FlashJob, std::string> FlashDaemon::parseJob(const std::string& request) {
+        try {
+            const parser::DeviceParser parsed{ request };
+            FlashJob job;
+            job.device = optionalValue(parsed, "/device").value_or("");
+            job.config = optionalValue(parsed, "/config").value_or("");
+            job.port = optionalValue(parsed, "/port").value_or("");
+            job.file = optionalValue(parsed, "/file").value_or("");
+            if ((job.device.empty() && job.config.empty()) || job.port.empty() || job.file.empty()) {
+                return utils::make_unexpected("A job needs a device or config, a port and a file");
+            }
+            if (!std::filesystem::path{ job.file }.is_absolute() ||
+                (!job.config.empty() && !std::filesystem::path{ job.config }.is_absolute())) {
+                return utils::make_unexpected("The file and config of a job need absolute paths");
+            }
+            if (optionalValue(parsed, "/baud")) {
+                job.baudrate = *parsed.getJSONValue<unsigned int>("/baud");
+            }
+            if (auto address = optionalValue(parsed, "/baseAddress")) {
+                const auto value = utils::parseAddress(*address);
+                if (!value) {
+                    return utils::make_unexpected("The base address of a job must be decimal or 0x prefixed hex");
+                }
+                job.baseAddress = *value;
+            }
+            if (auto directory = optionalValue(parsed, "/delta")) {
+                if (!std::filesystem::path{ *directory }.is_absolute()) {
+                    return utils::make_unexpected("The delta directory of a job needs an absolute path");
+                }
+                job.manifestDirectory = *directory;
+            }
+            return job;
+        } catch (std::exception& e) {
+            return utils::make_unexpected(std::string{ "Invalid job: " } + e.what());
+        }
+    }
+
+    std::size_t FlashDaemon::cachedConfigs() const {
+        std::lock_guard lock{ mMutex };
+        return mConfigs.size();
+    }
+
+    std::size_t FlashDaemon::cachedImages() const {
+        std::lock_guard lock{ mMutex };
+        return mImages.size();
+    }
+
+    std::size_t FlashDaemon::openPorts() const {
+        std::lock_guard lock{ mMutex };
+        return mPorts.size();
+    }
+
+    utils::expected<std::shared_ptr<const json::config::ConfigManager>, std::string> FlashDaemon::config(const FlashJob& job) {
+        const auto key = job.config.empty() ? job.device : job.config;
+        std::optional<CachedConfig> cached;
+        {
+            std::lock_guard lock{ mMutex };
+            if (auto entry = mConfigs.find(key); entry != std::end(mConfigs)) {
+                cached = entry->second;
+            }
+        }
+        if (cached && modificationTime(cached->source) == cached->modified) {
+            return cached->manager;
+        }
+
+        // looked up and parsed unlocked, the jobs on other ports don't wait for it
+        std::filesystem::path source{ job.config };
+        if (source.empty()) {
+            const auto location = ConfigFinder{ job.device }.getFileLocation();
+            if (!location) {
+                return utils::make_unexpected(location.error());
+            }
+            source = *location;
+        }
+        const auto modified = modificationTime(source);
+        auto manager = job.config.empty()
+                ? std::make_shared<const json::config::ConfigManager>(job.device, ConfigFinder::defaultFolder(), source)
+                : std::make_shared<const json::config::ConfigManager>(source);
+        if (!*manager) {
+            return utils::make_unexpected(*manager->errorMessage());
+        }
+        if (!manager->resolved()) {
+            return utils::make_unexpected(manager->resolved().error());
+        }
+
+        std::lock_guard lock{ mMutex };
+        auto& entry = mConfigs[key];
+        // a concurrent job loaded the same version, keep its manager so the ports opened with it stay in use
+        if (entry.manager && entry.source == source && entry.modified == modified) {
+            return entry.manager;
+        }
+        entry = CachedConfig{ manager, source, modified };
+        return manager;
+    }
+
+    utils::expected<std::shared_ptr<const reader::FirmwareImage>, std::string> FlashDaemon::image(
+            const FlashJob& job, const json::config::ResolvedDeviceConfig& config) {
+        const auto key = imageKey(job, config);
+        {
+            std::lock_guard lock{ mMutex };
+            auto cached = std::find_if(std::begin(mImages), std::end(mImages),
+                    [&key](const CachedImage& entry) { return entry.key == key; });
+            if (cached != std::end(mImages)) {
+                cached->lastUse = ++mUseCounter;
+                return cached->image;
+            }
+        }
+
+        // parsed unlocked, jobs with cached images don't wait for it
+        const auto format = reader::formatFromFile(job.file, config.binaryFormat);
+        auto firmware = reader::FirmwareImage::freeze(
+                reader::makeReader(format, job.file, config.deviceFlashAvailable, job.baseAddress));
+        if (!firmware) {
+            return utils::make_unexpected(std::string{ "Unknown Format!" });
+        }
+        if (!*firmware) {
+            return utils::make_unexpected(*firmware->errorMessage());
+        }
+
+        std::lock_guard lock{ mMutex };
+        if (mImages.size() >= mMaxCachedImages) {
+            mImages.erase(std::min_element(std::begin(mImages), std::end(mImages),
+                    [](const CachedImage& a, const CachedImage& b) { return a.lastUse < b.lastUse; }));
+        }
+        mImages.push_back(CachedImage{ key, firmware, ++mUseCounter });
+        return firmware;
+    }
+
+    utils::expected<std::unique_ptr<serial::DataSendManager>, std::string> FlashDaemon::acquirePort(
+            const FlashJob& job, const std::shared_ptr<const json::config::ConfigManager>& manager) {
+        std::unique_ptr<serial::DataSendManager> sendManager;
+        {
+            std::lock_guard lock{ mMutex };
+            if (!mBusyPorts.insert(job.port).second) {
+                return utils::make_unexpected("Port " + job.port + " is busy");
+            }
+            auto open = mPorts.find(job.port);
+            if (open != std::end(mPorts)) {
+                if (open->second.config == manager && open->second.baudrate == job.baudrate) {
+                    sendManager = std::move(open->second.manager);
+                }
+                mPorts.erase(open);
+            }
+        }
+
+        try {
+            if (sendManager) {
+                sendManager->restart();
+                return sendManager;
+            }
+            sendManager = mConnect(*manager, job.port, job.baudrate);
+        } catch (std::exception& e) {
+            releasePort(job, manager, nullptr);
+            return utils::make_unexpected(std::string{ e.what() });
+        }
+        if (!sendManager || !sendManager->isOpen()) {
+            const auto error = sendManager && sendManager->errorMessage() ? *sendManager->errorMessage()
+                                                                          : "Unable to open " + job.port;
+            releasePort(job, manager, nullptr);
+            return utils::make_unexpected(error);
+        }
+        return sendManager;
+    }
+
+    void FlashDaemon::releasePort(const FlashJob& job, const std::shared_ptr<const json::config::ConfigManager>& config,
+                                  std::unique_ptr<serial::DataSendManager> manager) {
+        std::lock_guard lock{ mMutex };
+        mBusyPorts.erase(job.port);
+        if (manager) {
+            mPorts[job.port] = OpenPort{ config, job.baudrate, std::move(manager) };
+        }
+    }
+}
@@ -0,0 +1,161 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include "../json/ConfigManager.h"
+#include "../loader/DataSendManager.h"
+#include "../loader/FirmwareImage.h"
+#include "../utils/expected.h"
+
+namespace firmware::daemon {
+    struct FlashJob {
+        std::string device;
+        std::string config;
+        std::string port;
+        std::string file;
+        unsigned int baudrate{ 9600 };
+        unsigned long baseAddress{ 0 };
+        std::optional<std::filesystem::path> manifestDirectory{ std::nullopt };
+    };
+
+    /**
+     * Serves flash jobs on a local socket, one JSON object per connection:
+     *
+     *     {"device": "atmega328p", "port": "/dev/ttyUSB0", "file": "/home/user/app.hex", "baud": 57600}
+     *
+     * "config" (a config file instead of the device name), "baseAddress" and
+     * "delta" (manifest directory) are optional. The daemon doesn't share the
+     * working directory of its clients, so "file", "config" and "delta" must
+     * be absolute paths, device names are looked up in the config folder of
+     * the daemon. The answer are
+     * "progress <percent>" lines and a final "ok <bytes> <milliseconds>" or
+     * "error <message>" line.
+     *
+     * Parsed configs, the most recently used images and the opened ports are
+     * kept between jobs, so a job on a known port only costs the transfer.
+     * Configs and images are loaded again once their file changes. Jobs on
+     * different ports run concurrently. Tuned settings and pipelining are up
+     * to the connect function, which builds the send manager of a port.
+     *
+     * Only the user running the daemon may connect to its socket.
+     */
+    class FlashDaemon {
+    public:
+        /**
+         * Opens the send manager of a port, a manager which isn't open is
+         * reported as error and not kept.
+         */
+        using ConnectFunction = std::function<std::unique_ptr<serial::DataSendManager>(
+                const json::config::ConfigManager& manager, const std::string& port, unsigned int baudrate)>;
+
+        using ReplyFunction = std::function<void(const std::string& line)>;
+
+        static constexpr std::size_t defaultCachedImages = 8;
+
+        static constexpr std::chrono::milliseconds defaultRequestTimeout{ 5000 };
+
+        /**
+         * A connection which doesn't send its request within the request
+         * timeout is closed.
+         */
+        FlashDaemon(std::filesystem::path socketPath, ConnectFunction connect,
+                    std::size_t cachedImages = defaultCachedImages,
+                    std::chrono::milliseconds requestTimeout = defaultRequestTimeout);
+
+        ~FlashDaemon();
+
+        FlashDaemon(const FlashDaemon&) = delete;
+
+        FlashDaemon& operator=(const FlashDaemon&) = delete;
+
+        /**
+         * Accepts jobs until stop() is called, returns false if the socket
+         * can't be opened.
+         */
+        bool run();
+
+        /**
+         * Ends run() once the running jobs are done, callable from any thread.
+         */
+        void stop();
+
+        /**
+         * Runs a single job, the socket connections use this as well.
+         */
+        void execute(const std::string& request, const ReplyFunction& reply);
+
+        [[nodiscard]] static utils::expected<FlashJob, std::string> parseJob(const std::string& request);
+
+        [[nodiscard]] std::size_t cachedConfigs() const;
+
+        [[nodiscard]] std::size_t cachedImages() const;
+
+        [[nodiscard]] std::size_t openPorts() const;
+
+    private:
+        struct CachedConfig {
+            std::shared_ptr<const json::config::ConfigManager> manager;
+            // the file the config was loaded from and its modification time when it was loaded
+            std::filesystem::path source;
+            std::filesystem::file_time_type modified;
+        };
+
+        struct CachedImage {
+            std::string key;
+            std::shared_ptr<const reader::FirmwareImage> image;
+            std::size_t lastUse;
+        };
+
+        struct OpenPort {
+            // a reloaded config gets a new manager, ports opened with the old one aren't reused
+            std::shared_ptr<const json::config::ConfigManager> config;
+            unsigned int baudrate;
+            std::unique_ptr<serial::DataSendManager> manager;
+        };
+
+        void connectionDone();
+
+        [[nodiscard]] utils::expected<std::shared_ptr<const json::config::ConfigManager>, std::string> config(const FlashJob& job);
+
+        [[nodiscard]] utils::expected<std::shared_ptr<const reader::FirmwareImage>, std::string> image(
+                const FlashJob& job, const json::config::ResolvedDeviceConfig& config);
+
+        [[nodiscard]] utils::expected<std::unique_ptr<serial::DataSendManager>, std::string> acquirePort(
+                const FlashJob& job, const std::shared_ptr<const json::config::ConfigManager>& manager);
+
+        void releasePort(const FlashJob& job, const std::shared_ptr<const json::config::ConfigManager>& config,
+                         std::unique_ptr<serial::DataSendManager> manager);
+
+        const std::filesystem::path mSocketPath;
+        const ConnectFunction mConnect;
+        const std::size_t mMaxCachedImages;
+        const std::chrono::milliseconds mRequestTimeout;
+        std::atomic<bool> mStopping{ false };
+
+        // connections are served by detached threads, run() waits for them before it returns
+        std::mutex mConnectionMutex;
+        std::condition_variable mConnectionsDone;
+        std::size_t mConnections{ 0 };
+
+        mutable std::mutex mMutex;
+        std::map<std::string, CachedConfig> mConfigs;
+        std::vector<CachedImage> mImages;
+        std::size_t mUseCounter{ 0 };
+        std::map<std::string, OpenPort> mPorts;
+        std::set<std::string> mBusyPorts;
+    };
+}
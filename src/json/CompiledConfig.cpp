@@ -0,0 +1,321 @@
+//
+// Created on 16.10.26.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "CompiledConfig.h"
+#include "DeviceRegistry.h"
+#include "../utils/fileUtils.h"
+
+namespace firmware::json::config {
+    namespace {
+        constexpr std::string_view compiledMagic = "FWDC";
+        constexpr std::uint32_t compiledVersion = 1;
+        constexpr auto compiledSuffix = ".fwcfg";
+
+        /**
+         * Calls the visitor with every field, in the order they are stored.
+         */
+        template<typename Config, typename Visitor, typename... Fields>
+        void visitFields(Config& config, Visitor& visit, ResolvedFieldList<Fields...>) {
+            (visit(config.*Fields::field), ...);
+        }
+
+        template<typename Config, typename Visitor>
+        void visitFields(Config& config, Visitor& visit) {
+            visitFields(config, visit, ResolvedFields{});
+        }
+
+        /**
+         * Last enumerator of every enum which is stored, values behind it
+         * can only come from a damaged file.
+         */
+        template<typename T>
+        struct EnumRange;
+
+        template<>
+        struct EnumRange<::serial::utils::Parity> {
+            static constexpr auto last = ::serial::utils::Parity::unknown;
+        };
+
+        template<>
+        struct EnumRange<::serial::utils::BinaryFormats> {
+            static constexpr auto last = ::serial::utils::BinaryFormats::Unknown;
+        };
+
+        template<>
+        struct EnumRange<::serial::utils::TransferModes> {
+            static constexpr auto last = ::serial::utils::TransferModes::Segmented;
+        };
+
+        template<>
+        struct EnumRange<::serial::utils::CompressionModes> {
+            static constexpr auto last = ::serial::utils::CompressionModes::PackBits;
+        };
+
+        struct SourceStamp {
+            std::uint64_t size;
+            std::int64_t modified;
+        };
+
+        utils::expected<SourceStamp, std::string> sourceStamp(const std::filesystem::path& source) {
+            std::error_code error;
+            const auto size = std::filesystem::file_size(source, error);
+            if (error) {
+                return utils::make_unexpected("Unable to Open: " + source.string());
+            }
+            const auto modified = std::filesystem::last_write_time(source, error);
+            if (error) {
+                return utils::make_unexpected("Unable to Open: " + source.string());
+            }
+            return SourceStamp{ size, static_cast<std::int64_t>(modified.time_since_epoch().count()) };
+        }
+
+        class FieldWriter {
+        public:
+            template<typename T>
+            void integer(T value) {
+                auto bits = static_cast<std::uint64_t>(value);
+                for (std::size_t i = 0; i < sizeof(T); i++) {
+                    mData.push_back(static_cast<char>(bits & 0xFF));
+                    bits >>= 8;
+                }
+            }
+
+            void operator()(const std::string& value) {
+                integer(static_cast<std::uint32_t>(value.size()));
+                mData += value;
+            }
+
+            void operator()(const CustomDataTypes::ComputerScience::byte& value) { integer(value.count()); }
+
+            void operator()(std::size_t value) { integer(static_cast<std::uint64_t>(value)); }
+
+            template<typename Rep, typename Period>
+            void operator()(const std::chrono::duration<Rep, Period>& value) { integer(static_cast<std::int64_t>(value.count())); }
+
+            void operator()(bool value) { integer(static_cast<std::uint8_t>(value)); }
+
+            void operator()(std::byte value) { integer(std::to_integer<std::uint8_t>(value)); }
+
+            template<typename T>
+#ifdef __cpp_concepts
+            requires std::is_enum_v<T>
+#endif
+            void operator()(T value) { integer(static_cast<std::uint32_t>(value)); }
+
+            void operator()(const ::serial::utils::SerialConfiguration& value) {
+                std::uint32_t stopBits;
+                static_assert(sizeof(stopBits) == sizeof(value.stopBits));
+                std::memcpy(&stopBits, &value.stopBits, sizeof(stopBits));
+                integer(static_cast<std::uint32_t>(value.dataBits));
+                (*this)(value.parityBit);
+                integer(stopBits);
+            }
+
+            template<typename T>
+            void operator()(const std::optional<T>& value) {
+                (*this)(value.has_value());
+                if (value) {
+                    (*this)(*value);
+                }
+            }
+
+            [[nodiscard]] std::string& data() noexcept { return mData; }
+
+        private:
+            std::string mData;
+        };
+
+        /**
+         * Reads fields back and remembers if the data ran out.
+         */
+        class FieldReader {
+        public:
+            explicit FieldReader(std::string_view data) : mData{ data } {}
+
+            template<typename T>
+            T integer() noexcept {
+                std::uint64_t bits = 0;
+                if (!take(sizeof(T))) {
+                    return T{};
+                }
+                for (std::size_t i = sizeof(T); i > 0; i--) {
+                    bits = (bits << 8) | static_cast<unsigned char>(mData[mPosition - sizeof(T) + i - 1]);
+                }
+                return static_cast<T>(bits);
+            }
+
+            void operator()(std::string& value) {
+                const auto size = integer<std::uint32_t>();
+                if (take(size)) {
+                    value = std::string{ mData.substr(mPosition - size, size) };
+                }
+            }
+
+            void operator()(CustomDataTypes::ComputerScience::byte& value) {
+                value = CustomDataTypes::ComputerScience::byte{ integer<std::intmax_t>() };
+            }
+
+            void operator()(std::size_t& value) { value = static_cast<std::size_t>(integer<std::uint64_t>()); }
+
+            template<typename Rep, typename Period>
+            void operator()(std::chrono::duration<Rep, Period>& value) {
+                value = std::chrono::duration<Rep, Period>{ static_cast<Rep>(integer<std::int64_t>()) };
+            }
+
+            void operator()(bool& value) { value = integer<std::uint8_t>() != 0; }
+
+            void operator()(std::byte& value) { value = std::byte{ integer<std::uint8_t>() }; }
+
+            template<typename T>
+#ifdef __cpp_concepts
+            requires std::is_enum_v<T>
+#endif
+            void operator()(T& value) {
+                const auto raw = integer<std::uint32_t>();
+                if (raw > static_cast<std::uint32_t>(EnumRange<T>::last)) {
+                    mValid = false;
+                    return;
+                }
+                value = static_cast<T>(raw);
+            }
+
+            void operator()(::serial::utils::SerialConfiguration& value) {
+                value.dataBits = integer<std::uint32_t>();
+                (*this)(value.parityBit);
+                const auto stopBits = integer<std::uint32_t>();
+                std::memcpy(&value.stopBits, &stopBits, sizeof(stopBits));
+            }
+
+            template<typename T>
+            void operator()(std::optional<T>& value) {
+                bool present = false;
+                (*this)(present);
+                if (present) {
+                    T element{};
+                    (*this)(element);
+                    value = element;
+                } else {
+                    value = std::nullopt;
+                }
+            }
+
+            [[nodiscard]] bool valid() const noexcept { return mValid; }
+
+            [[nodiscard]] bool atEnd() const noexcept { return mPosition == mData.size(); }
+
+        private:
+            bool take(std::size_t count) noexcept {
+                if (!mValid || mData.size() - mPosition < count) {
+                    mValid = false;
+                    return false;
+                }
+                mPosition += count;
+                return true;
+            }
+
+            std::string_view mData;
+            std::size_t mPosition{ 0 };
+            bool mValid{ true };
+        };
+    }
+
+    std::string compileConfig(const ResolvedDeviceConfig& config, const std::filesystem::path& source) {
+        const auto stamp = sourceStamp(source);
+        if (!stamp) {
+            throw std::runtime_error(stamp.error());
+        }
+        FieldWriter writer;
+        writer.data() += compiledMagic;
+        writer.integer(compiledVersion);
+        writer.integer(stamp->size);
+        writer.integer(stamp->modified);
+        visitFields(config, writer);
+        return std::move(writer.data());
+    }
+
+    utils::expected<ResolvedDeviceConfig, std::string> loadCompiledConfig(const std::filesystem::path& compiled,
+                                                                         const std::filesystem::path& source) {
+        const auto content = utils::readFile(compiled);
+        if (!content) {
+            return utils::make_unexpected(std::string{ content.error() });
+        }
+        const auto stamp = sourceStamp(source);
+        if (!stamp) {
+            return utils::make_unexpected(std::string{ stamp.error() });
+        }
+
+        const std::string_view data{ *content };
+        if (data.substr(0, compiledMagic.size()) != compiledMagic) {
+            return utils::make_unexpected("Not a compiled config: " + compiled.string());
+        }
+        FieldReader reader{ data.substr(compiledMagic.size()) };
+        if (reader.integer<std::uint32_t>() != compiledVersion) {
+            return utils::make_unexpected("Compiled config has another version: " + compiled.string());
+        }
+        const auto size = reader.integer<std::uint64_t>();
+        const auto modified = reader.integer<std::int64_t>();
+        if (size != stamp->size || modified != stamp->modified) {
+            return utils::make_unexpected("Compiled config is outdated: " + compiled.string());
+        }
+
+        ResolvedDeviceConfig config;
+        visitFields(config, reader);
+        if (!reader.valid() || !reader.atEnd()) {
+            return utils::make_unexpected("Compiled config is damaged: " + compiled.string());
+        }
+        return config;
+    }
+
+    std::filesystem::path compiledConfigPath(const std::filesystem::path& folder, const std::string& deviceName) {
+        return folder / (deviceName + compiledSuffix);
+    }
+
+    std::filesystem::path compiledConfigFolder(const std::filesystem::path& configFolder) {
+        return configFolder / "compiled";
+    }
+
+    CompileReport compileConfigs(const std::filesystem::path& configFolder, const std::filesystem::path& outputFolder) {
+        CompileReport report;
+        std::error_code error;
+        std::filesystem::create_directories(outputFolder, error);
+        if (error) {
+            report.errors.push_back("Unable to create " + outputFolder.string());
+            return report;
+        }
+
+        const DeviceRegistry registry{ configFolder };
+        for (const auto& [id, entry] : registry.devices()) {
+            const ConfigManager manager{ entry.path };
+            const auto& config = manager.resolved();
+            if (!config) {
+                report.errors.push_back(entry.path.string() + ": " + config.error());
+                continue;
+            }
+            try {
+                const auto compiled = compileConfig(*config, entry.path);
+                const auto target = compiledConfigPath(outputFolder, id);
+                auto temporary = target;
+                temporary += ".tmp";
+                {
+                    std::ofstream stream{ temporary, std::ios::binary | std::ios::trunc };
+                    stream.write(compiled.data(), static_cast<std::streamsize>(compiled.size()));
+                    if (!stream.good()) {
+                        report.errors.push_back("Unable to write " + temporary.string());
+                        continue;
+                    }
+                }
+                std::filesystem::rename(temporary, target);
+                report.compiled++;
+            } catch (std::exception& e) {
+                report.errors.push_back(entry.path.string() + ": " + e.what());
+            }
+        }
+        return report;
+    }
+}
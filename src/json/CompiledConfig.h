@@ -0,0 +1,49 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "ConfigManager.h"
+#include "../utils/expected.h"
+
+namespace firmware::json::config {
+    /**
+     * Binary form of a ResolvedDeviceConfig, loaded without any JSON parsing
+     * or unit conversion. Layout (little endian):
+     *   magic "FWDC", u32 version, u64 source size, i64 source modification
+     *   time, then every field of ResolvedDeviceConfig in declaration order.
+     * Strings are stored as u32 length and characters, optional values with
+     * a leading presence byte.
+     */
+    [[nodiscard]] std::string compileConfig(const ResolvedDeviceConfig& config, const std::filesystem::path& source);
+
+    /**
+     * Fails if the file is damaged, from another version, or if the source
+     * config changed since it was compiled.
+     */
+    [[nodiscard]] utils::expected<ResolvedDeviceConfig, std::string> loadCompiledConfig(const std::filesystem::path& compiled,
+                                                                                       const std::filesystem::path& source);
+
+    [[nodiscard]] std::filesystem::path compiledConfigPath(const std::filesystem::path& folder, const std::string& deviceName);
+
+    /**
+     * Where compile-configs writes the compiled form of the configs in
+     * configFolder by default, and where ConfigManager looks for them.
+     */
+    [[nodiscard]] std::filesystem::path compiledConfigFolder(const std::filesystem::path& configFolder);
+
+    struct CompileReport {
+        std::size_t compiled{ 0 };
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * Validates every device config below configFolder and writes the
+     * compiled form of each valid one to outputFolder.
+     */
+    [[nodiscard]] CompileReport compileConfigs(const std::filesystem::path& configFolder, const std::filesystem::path& outputFolder);
+}
@@ -3,20 +3,37 @@
 //
 
 #include "ConfigManager.h"
+#include "CompiledConfig.h"
+#include "../utils/Trace.h"
 namespace firmware::json::config {
-    ConfigManager::ConfigManager(const std::string &deviceName) {
-        ConfigFinder config{deviceName};
-        if (auto &content = config.getFileContents()) {
-            if(!content->empty()) {
-                mParser.emplace(*content);
-            } else {
-                mError = "config should not be empty!";
+    ConfigManager::ConfigManager(const std::string &deviceName) :
+            ConfigManager{deviceName, ConfigFinder::defaultFolder()} {}
+
+    ConfigManager::ConfigManager(const std::string &deviceName, const std::filesystem::path& configFolder) {
+        ConfigFinder config{deviceName, configFolder};
+        if (auto location = config.getFileLocation()) {
+            if (!loadCompiled(*location, configFolder, deviceName)) {
+                load(*location);
             }
-        } else {
-            mError = content.error();
+            return;
+        }
+        mError = config.getFileContents().error();
+        mResolved = resolve();
+    }
+
+    ConfigManager::ConfigManager(const std::string &deviceName, const std::filesystem::path& configFolder,
+                                 const std::filesystem::path& source) {
+        if (!loadCompiled(source, configFolder, deviceName)) {
+            load(source);
         }
     }
+
     ConfigManager::ConfigManager(const std::filesystem::path& filePath) {
+        load(filePath);
+    }
+
+    void ConfigManager::load(const std::filesystem::path& filePath) {
+        const utils::trace::Span span{ "json parse", "config" };
         auto fileContent = utils::readFile(filePath);
         if (fileContent) {
             if(!fileContent->empty()) {
@@ -27,5 +44,67 @@ namespace firmware::json::config {
         } else {
             mError = fileContent.error();
         }
+        mResolved = resolve();
+    }
+
+    bool ConfigManager::loadCompiled(const std::filesystem::path& source, const std::filesystem::path& configFolder,
+                                     const std::string& deviceName) {
+        const utils::trace::Span span{ "load compiled config", "config" };
+        const auto compiled = compiledConfigPath(compiledConfigFolder(configFolder), deviceName);
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(compiled, error)) {
+            return false;
+        }
+        auto loaded = loadCompiledConfig(compiled, source);
+        if (!loaded) {
+            return false;
+        }
+        mResolved = std::move(*loaded);
+        return true;
+    }
+
+    utils::expected<ResolvedDeviceConfig, std::string> ConfigManager::resolve() const {
+        if (mError) {
+            return utils::make_unexpected(*mError);
+        }
+        // compiled configs have no parser, their options were resolved when they were compiled
+        if (!mParser) {
+            return mResolved;
+        }
+        try {
+            return ResolvedDeviceConfig{
+                .deviceID = getJSONValue<JsonOptions::deviceID>(),
+                .deviceVendor = getJSONValue<JsonOptions::deviceVendor>(),
+                .deviceArch = getJSONValue<JsonOptions::deviceArch>(),
+                .deviceSubArch = getJSONValue<JsonOptions::deviceSubArch>(),
+                .deviceName = getJSONValue<JsonOptions::deviceName>(),
+                .deviceFlashTotal = getJSONValue<JsonOptions::deviceFlashTotal>(),
+                .deviceFlashAvailable = getJSONValue<JsonOptions::deviceFlashAvailable>(),
+                .deviceFlashPageSize = getOptionalJSONValue<JsonOptions::deviceFlashPageSize>().value_or(0),
+                .deviceEEPROMTotal = getJSONValue<JsonOptions::deviceEEPROMTotal>(),
+                .deviceEEPROMAvailable = getJSONValue<JsonOptions::deviceEEPROMAvailable>(),
+                .serialMode = getJSONValue<JsonOptions::serialMode>(),
+                .serialBytesPerBurst = getJSONValue<JsonOptions::serialBytesPerBurst>(),
+                .serialMetadataSize = getJSONValue<JsonOptions::serialMetadataSize>(),
+                .serialMinBaudRate = getJSONValue<JsonOptions::serialMinBaudRate>(),
+                .serialMaxBaudRate = getJSONValue<JsonOptions::serialMaxBaudRate>(),
+                .serialWaitTimeForReset = getJSONValue<JsonOptions::serialWaitTimeForReset>(),
+                .serialEEPROMBurstDelay = getJSONValue<JsonOptions::serialEEPROMBurstDelay>(),
+                .serialFlashBurstDelay = getJSONValue<JsonOptions::serialFlashBurstDelay>(),
+                .serialSyncByteAmount = getJSONValue<JsonOptions::serialSyncByteAmount>(),
+                .serialPreamble = getJSONValue<JsonOptions::serialPreamble>(),
+                .serialResyncAfterBurst = getJSONValue<JsonOptions::serialResyncAfterBurst>(),
+                .serialSyncByte = getJSONValue<JsonOptions::serialSyncByte>(),
+                .serialAckByte = getOptionalJSONValue<JsonOptions::serialAckByte>(),
+                .serialAckWindow = getOptionalJSONValue<JsonOptions::serialAckWindow>().value_or(1),
+                .serialAckTimeout = getOptionalJSONValue<JsonOptions::serialAckTimeout>().value_or(std::chrono::seconds{ 1 }),
+                .binaryFormat = getJSONValue<JsonOptions::binaryFormat>(),
+                .binaryTransfer = getOptionalJSONValue<JsonOptions::binaryTransfer>().value_or(serial::utils::TransferModes::Linear),
+                .binaryCompression = getOptionalJSONValue<JsonOptions::binaryCompression>().value_or(serial::utils::CompressionModes::None),
+                .unusedFlashByte = getJSONValue<JsonOptions::unusedFlashByte>()
+            };
+        } catch (std::exception& e) {
+            return utils::make_unexpected(std::string{ e.what() });
+        }
     }
 }
\ No newline at end of file
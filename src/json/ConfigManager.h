@@ -29,6 +29,7 @@ namespace firmware::json::config {
         deviceName,
         deviceFlashTotal,
         deviceFlashAvailable,
+        deviceFlashPageSize,
         deviceEEPROMTotal,
         deviceEEPROMAvailable,
         serialMode,
@@ -43,7 +44,12 @@ namespace firmware::json::config {
         serialPreamble,
         serialResyncAfterBurst,
         serialSyncByte,
+        serialAckByte,
+        serialAckWindow,
+        serialAckTimeout,
         binaryFormat,
+        binaryTransfer,
+        binaryCompression,
         unusedFlashByte
     };
 
@@ -115,6 +121,13 @@ namespace firmware::json::config {
             };
         };
 
+        template<>
+        struct DeviceOptions<JsonOptions::deviceFlashPageSize> {
+            static constexpr auto jsonKey = "/device/flash/pageSize";
+            using type = std::size_t;
+            static constexpr auto converter = [](const std::string& input) noexcept { return input; };
+        };
+
         template<>
         struct DeviceOptions<JsonOptions::deviceEEPROMTotal> {
             static constexpr auto jsonKey = "/device/eeprom/total";
@@ -285,6 +298,34 @@ namespace firmware::json::config {
             };
         };
 
+        template<>
+        struct DeviceOptions<JsonOptions::serialAckByte> {
+            static constexpr auto jsonKey = "/serial/sync/ackByte";
+            using type = std::byte;
+            static constexpr auto converter = [](const std::string& input) noexcept { return input; };
+        };
+
+        template<>
+        struct DeviceOptions<JsonOptions::serialAckWindow> {
+            static constexpr auto jsonKey = "/serial/sync/ackWindow";
+            using type = std::size_t;
+            static constexpr auto converter = [](const std::string& input) noexcept { return input; };
+        };
+
+        template<>
+        struct DeviceOptions<JsonOptions::serialAckTimeout> {
+            static constexpr auto jsonKey = "/serial/sync/ackTimeout";
+            using type = std::chrono::milliseconds;
+            static constexpr auto converter = [](const std::string& input) noexcept -> utils::expected<type, std::string> {
+                auto val = CustomDataTypes::parseUnit<type>(input);
+                if (val) {
+                    return { *val };
+                } else {
+                    return utils::make_unexpected("Unable to convert serialAckTimeout to milliseconds value!");
+                }
+            };
+        };
+
         template<>
         struct DeviceOptions<JsonOptions::binaryFormat> {
             static constexpr auto jsonKey = "/binary/format";
@@ -294,10 +335,48 @@ namespace firmware::json::config {
                 if (input == "intel hex") {
                     return type::IntelHex;
                 }
+                if (input == "raw binary" || input == "binary") {
+                    return type::RawBinary;
+                }
+                if (input == "s-record" || input == "srec") {
+                    return type::SRecord;
+                }
                 return type::Unknown;
             };
         };
 
+        template<>
+        struct DeviceOptions<JsonOptions::binaryTransfer> {
+            static constexpr auto jsonKey = "/binary/transfer";
+            using type = serial::utils::TransferModes;
+            static constexpr auto converter = [](std::string input) noexcept -> utils::expected<type, std::string> {
+                std::transform(input.begin(), input.end(), input.begin(), ::tolower);
+                if (input == "linear") {
+                    return type::Linear;
+                }
+                if (input == "segmented") {
+                    return type::Segmented;
+                }
+                return utils::make_unexpected("Unknown transfer mode (possible values: linear, segmented)");
+            };
+        };
+
+        template<>
+        struct DeviceOptions<JsonOptions::binaryCompression> {
+            static constexpr auto jsonKey = "/binary/compression";
+            using type = serial::utils::CompressionModes;
+            static constexpr auto converter = [](std::string input) noexcept -> utils::expected<type, std::string> {
+                std::transform(input.begin(), input.end(), input.begin(), ::tolower);
+                if (input == "none") {
+                    return type::None;
+                }
+                if (input == "packbits" || input == "rle") {
+                    return type::PackBits;
+                }
+                return utils::make_unexpected("Unknown compression (possible values: none, packbits)");
+            };
+        };
+
         template<>
         struct DeviceOptions < JsonOptions::unusedFlashByte> {
             static constexpr auto jsonKey = "/binary/unusedFlashByte";
@@ -306,12 +385,161 @@ namespace firmware::json::config {
         };
     }
 
+    template<JsonOptions option>
+    using option_t = typename DeviceOptions<option>::type;
+
+    /**
+     * Every device option, converted once when the config is loaded. Code
+     * which reads options repeatedly (e.g. per burst) should use this
+     * instead of ConfigManager::getJSONValue.
+     */
+    struct ResolvedDeviceConfig {
+        option_t<JsonOptions::deviceID> deviceID;
+        option_t<JsonOptions::deviceVendor> deviceVendor;
+        option_t<JsonOptions::deviceArch> deviceArch;
+        option_t<JsonOptions::deviceSubArch> deviceSubArch;
+        option_t<JsonOptions::deviceName> deviceName;
+        option_t<JsonOptions::deviceFlashTotal> deviceFlashTotal;
+        option_t<JsonOptions::deviceFlashAvailable> deviceFlashAvailable;
+        // 0 if the config doesn't specify a page size
+        option_t<JsonOptions::deviceFlashPageSize> deviceFlashPageSize;
+        option_t<JsonOptions::deviceEEPROMTotal> deviceEEPROMTotal;
+        option_t<JsonOptions::deviceEEPROMAvailable> deviceEEPROMAvailable;
+        option_t<JsonOptions::serialMode> serialMode;
+        option_t<JsonOptions::serialBytesPerBurst> serialBytesPerBurst;
+        option_t<JsonOptions::serialMetadataSize> serialMetadataSize;
+        option_t<JsonOptions::serialMinBaudRate> serialMinBaudRate;
+        option_t<JsonOptions::serialMaxBaudRate> serialMaxBaudRate;
+        option_t<JsonOptions::serialWaitTimeForReset> serialWaitTimeForReset;
+        option_t<JsonOptions::serialEEPROMBurstDelay> serialEEPROMBurstDelay;
+        option_t<JsonOptions::serialFlashBurstDelay> serialFlashBurstDelay;
+        option_t<JsonOptions::serialSyncByteAmount> serialSyncByteAmount;
+        option_t<JsonOptions::serialPreamble> serialPreamble;
+        option_t<JsonOptions::serialResyncAfterBurst> serialResyncAfterBurst;
+        option_t<JsonOptions::serialSyncByte> serialSyncByte;
+        // the acknowledgement protocol is only used if an ackByte is configured
+        std::optional<option_t<JsonOptions::serialAckByte>> serialAckByte;
+        option_t<JsonOptions::serialAckWindow> serialAckWindow;
+        option_t<JsonOptions::serialAckTimeout> serialAckTimeout;
+        option_t<JsonOptions::binaryFormat> binaryFormat;
+        option_t<JsonOptions::binaryTransfer> binaryTransfer;
+        option_t<JsonOptions::binaryCompression> binaryCompression;
+        option_t<JsonOptions::unusedFlashByte> unusedFlashByte;
+
+        /**
+         * Unit of delta and blank page detection, a burst if the device
+         * doesn't specify its flash pages.
+         */
+        [[nodiscard]] std::size_t flashPageSize() const noexcept {
+            return deviceFlashPageSize > 0 ? deviceFlashPageSize : serialBytesPerBurst;
+        }
+    };
+
+    /**
+     * Connects an option to its member of ResolvedDeviceConfig.
+     */
+    template<JsonOptions jsonOption, auto member>
+    struct ResolvedField {
+        static constexpr JsonOptions option = jsonOption;
+        static constexpr auto field = member;
+    };
+
+    template<typename... Fields>
+    struct ResolvedFieldList {};
+
+    /**
+     * Every field of ResolvedDeviceConfig in declaration order, which is also
+     * the order of JsonOptions and of the compiled config format.
+     */
+    using ResolvedFields = ResolvedFieldList<
+            ResolvedField<JsonOptions::deviceID, &ResolvedDeviceConfig::deviceID>,
+            ResolvedField<JsonOptions::deviceVendor, &ResolvedDeviceConfig::deviceVendor>,
+            ResolvedField<JsonOptions::deviceArch, &ResolvedDeviceConfig::deviceArch>,
+            ResolvedField<JsonOptions::deviceSubArch, &ResolvedDeviceConfig::deviceSubArch>,
+            ResolvedField<JsonOptions::deviceName, &ResolvedDeviceConfig::deviceName>,
+            ResolvedField<JsonOptions::deviceFlashTotal, &ResolvedDeviceConfig::deviceFlashTotal>,
+            ResolvedField<JsonOptions::deviceFlashAvailable, &ResolvedDeviceConfig::deviceFlashAvailable>,
+            ResolvedField<JsonOptions::deviceFlashPageSize, &ResolvedDeviceConfig::deviceFlashPageSize>,
+            ResolvedField<JsonOptions::deviceEEPROMTotal, &ResolvedDeviceConfig::deviceEEPROMTotal>,
+            ResolvedField<JsonOptions::deviceEEPROMAvailable, &ResolvedDeviceConfig::deviceEEPROMAvailable>,
+            ResolvedField<JsonOptions::serialMode, &ResolvedDeviceConfig::serialMode>,
+            ResolvedField<JsonOptions::serialBytesPerBurst, &ResolvedDeviceConfig::serialBytesPerBurst>,
+            ResolvedField<JsonOptions::serialMetadataSize, &ResolvedDeviceConfig::serialMetadataSize>,
+            ResolvedField<JsonOptions::serialMinBaudRate, &ResolvedDeviceConfig::serialMinBaudRate>,
+            ResolvedField<JsonOptions::serialMaxBaudRate, &ResolvedDeviceConfig::serialMaxBaudRate>,
+            ResolvedField<JsonOptions::serialWaitTimeForReset, &ResolvedDeviceConfig::serialWaitTimeForReset>,
+            ResolvedField<JsonOptions::serialEEPROMBurstDelay, &ResolvedDeviceConfig::serialEEPROMBurstDelay>,
+            ResolvedField<JsonOptions::serialFlashBurstDelay, &ResolvedDeviceConfig::serialFlashBurstDelay>,
+            ResolvedField<JsonOptions::serialSyncByteAmount, &ResolvedDeviceConfig::serialSyncByteAmount>,
+            ResolvedField<JsonOptions::serialPreamble, &ResolvedDeviceConfig::serialPreamble>,
+            ResolvedField<JsonOptions::serialResyncAfterBurst, &ResolvedDeviceConfig::serialResyncAfterBurst>,
+            ResolvedField<JsonOptions::serialSyncByte, &ResolvedDeviceConfig::serialSyncByte>,
+            ResolvedField<JsonOptions::serialAckByte, &ResolvedDeviceConfig::serialAckByte>,
+            ResolvedField<JsonOptions::serialAckWindow, &ResolvedDeviceConfig::serialAckWindow>,
+            ResolvedField<JsonOptions::serialAckTimeout, &ResolvedDeviceConfig::serialAckTimeout>,
+            ResolvedField<JsonOptions::binaryFormat, &ResolvedDeviceConfig::binaryFormat>,
+            ResolvedField<JsonOptions::binaryTransfer, &ResolvedDeviceConfig::binaryTransfer>,
+            ResolvedField<JsonOptions::binaryCompression, &ResolvedDeviceConfig::binaryCompression>,
+            ResolvedField<JsonOptions::unusedFlashByte, &ResolvedDeviceConfig::unusedFlashByte>
+    >;
+
+    namespace detail {
+        template<typename... Fields>
+        constexpr bool coversEveryOption(ResolvedFieldList<Fields...>) {
+            std::size_t index = 0;
+            return ((static_cast<std::size_t>(Fields::option) == index++) && ...) &&
+                   index == static_cast<std::size_t>(JsonOptions::unusedFlashByte) + 1;
+        }
+
+        template<JsonOptions option, typename Field, typename... Rest>
+        constexpr auto resolvedMember(ResolvedFieldList<Field, Rest...>) {
+            if constexpr (Field::option == option) {
+                return Field::field;
+            } else {
+                return resolvedMember<option>(ResolvedFieldList<Rest...>{});
+            }
+        }
+    }
+
+    static_assert(detail::coversEveryOption(ResolvedFields{}), "ResolvedFields must list every option in order");
+
+    /**
+     * One option of a resolved config, nothing for an optional option the
+     * config doesn't set. Optional options with a default always have a
+     * value, the resolved config doesn't remember whether it was set.
+     */
+    template<JsonOptions option>
+    [[nodiscard]] std::optional<option_t<option>> resolvedOption(const ResolvedDeviceConfig& config) {
+        const auto& value = config.*detail::resolvedMember<option>(ResolvedFields{});
+        if constexpr (option == JsonOptions::deviceFlashPageSize) {
+            return value > 0 ? std::optional{ value } : std::nullopt;
+        } else {
+            return value;
+        }
+    }
+
     class ConfigManager {
     public:
         explicit ConfigManager(const std::string &deviceName);
 
+        /**
+         * Looks the device up below the given config folder. A compiled
+         * config of the device in compiledConfigFolder(configFolder) is used
+         * instead of the JSON while it is up to date.
+         */
+        ConfigManager(const std::string &deviceName, const std::filesystem::path& configFolder);
+
+        /**
+         * Like the constructor above, for a device whose config file below
+         * the config folder was already looked up.
+         */
+        ConfigManager(const std::string &deviceName, const std::filesystem::path& configFolder,
+                      const std::filesystem::path& source);
+
         ConfigManager(const std::filesystem::path& filePath);
 
+        [[nodiscard]] utils::expected<ResolvedDeviceConfig, std::string> resolve() const;
+
         template<JsonOptions value>
 #ifdef __cpp_concepts
         /*requires requires{
@@ -321,6 +549,16 @@ namespace firmware::json::config {
 #endif
         [[nodiscard]] typename DeviceOptions<value>::type getJSONValue() const {
             using optionStruct = DeviceOptions<value>;
+            // compiled configs have no JSON, their options are served from the resolved config
+            if (!mParser) {
+                if (!mResolved) {
+                    throw std::runtime_error(mResolved.error());
+                }
+                if (auto resolvedValue = resolvedOption<value>(*mResolved)) {
+                    return *resolvedValue;
+                }
+                throw std::runtime_error(std::string{ "Option not set: " } + optionStruct::jsonKey);
+            }
             if constexpr (std::is_same_v<typename optionStruct::type, std::string>) {
                 auto val = mParser->getJsonAsString(optionStruct::jsonKey);
                 if(!val) {
@@ -352,6 +590,29 @@ namespace firmware::json::config {
                 }
             }
         }
+        /**
+         * All options of the loaded config, or the first option which couldn't
+         * be read or converted.
+         */
+        [[nodiscard]] const utils::expected<ResolvedDeviceConfig, std::string>& resolved() const noexcept {
+            return mResolved;
+        }
+
+        /**
+         * Like getJSONValue, but returns nothing instead of throwing if the
+         * option is missing from the config. Invalid values still throw.
+         */
+        template<JsonOptions value>
+        [[nodiscard]] std::optional<typename DeviceOptions<value>::type> getOptionalJSONValue() const {
+            if (!mParser) {
+                return mResolved ? resolvedOption<value>(*mResolved) : std::nullopt;
+            }
+            if (!mParser->getJsonAsString(DeviceOptions<value>::jsonKey)) {
+                return std::nullopt;
+            }
+            return getJSONValue<value>();
+        }
+
         [[nodiscard]] const std::optional<std::string>& errorMessage() const noexcept {
             return mError;
         }
@@ -360,7 +621,16 @@ namespace firmware::json::config {
             return !static_cast<bool>(mError);
         }
     private:
+        /**
+         * Takes the options from the compiled form of the source config, if
+         * there is one which is still up to date.
+         */
+        bool loadCompiled(const std::filesystem::path& source, const std::filesystem::path& configFolder, const std::string& deviceName);
+
+        void load(const std::filesystem::path& filePath);
+
         std::optional<parser::DeviceParser> mParser = std::nullopt;
         std::optional<std::string> mError = std::nullopt;
+        utils::expected<ResolvedDeviceConfig, std::string> mResolved = utils::make_unexpected(std::string{ "config not loaded" });
     };
 }
@@ -0,0 +1,178 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "DeviceRegistry.h"
+#include "deviceParser.h"
+#include "../utils/fileUtils.h"
+
+namespace firmware::json::config {
+    namespace {
+        constexpr auto indexHeader = "firmware-loader device index 1";
+        constexpr auto configSuffix = ".json";
+
+        std::optional<std::filesystem::file_time_type::rep> modificationTime(const std::filesystem::path& path) {
+            std::error_code error;
+            const auto time = std::filesystem::last_write_time(path, error);
+            if (error) {
+                return std::nullopt;
+            }
+            return time.time_since_epoch().count();
+        }
+
+        std::string jsonValue(const parser::DeviceParser& parser, const std::string& key) {
+            auto value = parser.getJsonAsString(key);
+            return value ? *value : std::string{};
+        }
+    }
+
+    DeviceRegistry::DeviceRegistry(std::filesystem::path root, std::optional<std::filesystem::path> cacheFile) :
+            mRoot{ std::move(root) } {
+        if (cacheFile && load(*cacheFile)) {
+            mLoadedFromCache = true;
+            return;
+        }
+        scan();
+        if (cacheFile) {
+            store(*cacheFile);
+        }
+    }
+
+    std::optional<DeviceEntry> DeviceRegistry::find(const std::string& id) const {
+        auto entry = mDevices.find(id);
+        if (entry == std::end(mDevices)) {
+            return std::nullopt;
+        }
+        return entry->second;
+    }
+
+    bool DeviceRegistry::upToDate() const {
+        return !mDirectories.empty() && std::all_of(std::begin(mDirectories), std::end(mDirectories),
+                [](const DirectoryStamp& directory) { return modificationTime(directory.path) == directory.modified; });
+    }
+
+    void DeviceRegistry::rescan(const std::optional<std::filesystem::path>& cacheFile) {
+        mDevices.clear();
+        mDirectories.clear();
+        mLoadedFromCache = false;
+        scan();
+        if (cacheFile) {
+            store(*cacheFile);
+        }
+    }
+
+    std::filesystem::path DeviceRegistry::defaultCacheFile(const std::filesystem::path& root) {
+        std::error_code error;
+        auto absolute = std::filesystem::absolute(root, error).lexically_normal().string();
+        return std::filesystem::temp_directory_path(error) /
+               ("firmware-loader-devices-" + std::to_string(std::hash<std::string>{}(absolute)) + ".index");
+    }
+
+    void DeviceRegistry::scan() {
+        std::error_code error;
+        if (auto modified = modificationTime(mRoot)) {
+            mDirectories.push_back(DirectoryStamp{ mRoot, *modified });
+        }
+        for (std::filesystem::recursive_directory_iterator it{ mRoot, error }, end; !error && it != end; it.increment(error)) {
+            const auto& path = it->path();
+            if (it->is_directory(error)) {
+                if (auto modified = modificationTime(path)) {
+                    mDirectories.push_back(DirectoryStamp{ path, *modified });
+                }
+                continue;
+            }
+            if (path.extension() != configSuffix) {
+                continue;
+            }
+            DeviceEntry entry{ path, {}, {} };
+            // files which aren't valid configs are still found, the config manager reports their error
+            try {
+                if (auto content = utils::readFile(path); content && !content->empty()) {
+                    const parser::DeviceParser parser{ *content };
+                    entry.vendor = jsonValue(parser, "/device/general/vendor");
+                    entry.arch = jsonValue(parser, "/device/general/arch");
+                }
+            } catch (std::exception&) {
+            }
+            addDevice(path.stem().string(), std::move(entry));
+        }
+    }
+
+    void DeviceRegistry::addDevice(const std::string& id, DeviceEntry entry) {
+        // the iteration order isn't specified, duplicates resolve to the smallest path
+        auto [existing, inserted] = mDevices.try_emplace(id, entry);
+        if (!inserted && entry.path < existing->second.path) {
+            existing->second = std::move(entry);
+        }
+    }
+
+    bool DeviceRegistry::load(const std::filesystem::path& cacheFile) {
+        std::ifstream stream{ cacheFile };
+        std::string line;
+        if (!std::getline(stream, line) || line != indexHeader) {
+            return false;
+        }
+        if (!std::getline(stream, line) || line != mRoot.string()) {
+            return false;
+        }
+        while (std::getline(stream, line)) {
+            std::stringstream fields{ line };
+            std::string type;
+            std::getline(fields, type, '\t');
+            if (type == "d") {
+                std::string modified;
+                std::string path;
+                std::getline(fields, modified, '\t');
+                std::getline(fields, path);
+                const auto current = modificationTime(path);
+                if (!current || std::to_string(*current) != modified) {
+                    mDevices.clear();
+                    mDirectories.clear();
+                    return false;
+                }
+                mDirectories.push_back(DirectoryStamp{ path, *current });
+            } else if (type == "f") {
+                std::string id;
+                DeviceEntry entry;
+                std::string path;
+                std::getline(fields, id, '\t');
+                std::getline(fields, entry.vendor, '\t');
+                std::getline(fields, entry.arch, '\t');
+                std::getline(fields, path);
+                entry.path = path;
+                mDevices.emplace(id, std::move(entry));
+            }
+        }
+        return !mDirectories.empty();
+    }
+
+    bool DeviceRegistry::store(const std::filesystem::path& cacheFile) const noexcept {
+        if (mDirectories.empty()) {
+            return false;
+        }
+        try {
+            auto temporary = cacheFile;
+            temporary += ".tmp";
+            {
+                std::ofstream stream{ temporary, std::ios::trunc };
+                stream << indexHeader << '\n' << mRoot.string() << '\n';
+                for (const auto& directory : mDirectories) {
+                    stream << "d\t" << directory.modified << '\t' << directory.path.string() << '\n';
+                }
+                for (const auto& [id, entry] : mDevices) {
+                    stream << "f\t" << id << '\t' << entry.vendor << '\t' << entry.arch << '\t' << entry.path.string() << '\n';
+                }
+                if (!stream.good()) {
+                    return false;
+                }
+            }
+            std::filesystem::rename(temporary, cacheFile);
+            return true;
+        } catch (std::exception&) {
+            return false;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace firmware::json::config {
+    struct DeviceEntry {
+        std::filesystem::path path;
+        std::string vendor;
+        std::string arch;
+    };
+
+    /**
+     * Index of every device config below a directory, keyed by the file name
+     * without ".json". The tree is scanned once, the index is kept in a cache
+     * file together with the modification time of every directory, and is
+     * scanned again only if one of them changed. Edits inside a config file
+     * don't touch the directory, so vendor and arch of the index can be
+     * outdated until the next scan, the path stays valid.
+     */
+    class DeviceRegistry {
+    public:
+        explicit DeviceRegistry(std::filesystem::path root, std::optional<std::filesystem::path> cacheFile = std::nullopt);
+
+        [[nodiscard]] std::optional<DeviceEntry> find(const std::string& id) const;
+
+        [[nodiscard]] const std::unordered_map<std::string, DeviceEntry>& devices() const noexcept { return mDevices; }
+
+        [[nodiscard]] bool loadedFromCache() const noexcept { return mLoadedFromCache; }
+
+        /**
+         * Whether no directory of the tree changed since the index was built,
+         * costs a stat per directory.
+         */
+        [[nodiscard]] bool upToDate() const;
+
+        /**
+         * Scans the tree again and rewrites the cache file, if given.
+         */
+        void rescan(const std::optional<std::filesystem::path>& cacheFile = std::nullopt);
+
+        /**
+         * Cache file of a config tree in the temporary directory, so writing
+         * it doesn't change the modification time of the tree itself.
+         */
+        [[nodiscard]] static std::filesystem::path defaultCacheFile(const std::filesystem::path& root);
+
+    private:
+        struct DirectoryStamp {
+            std::filesystem::path path;
+            std::filesystem::file_time_type::rep modified;
+        };
+
+        void scan();
+
+        bool load(const std::filesystem::path& cacheFile);
+
+        bool store(const std::filesystem::path& cacheFile) const noexcept;
+
+        void addDevice(const std::string& id, DeviceEntry entry);
+
+        std::filesystem::path mRoot;
+        std::unordered_map<std::string, DeviceEntry> mDevices;
+        std::vector<DirectoryStamp> mDirectories;
+        bool mLoadedFromCache{ false };
+    };
+}
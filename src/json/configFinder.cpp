@@ -3,12 +3,58 @@
 //
 
 #include "configFinder.h"
+#include "../utils/Trace.h"
 
 namespace fs = std::filesystem;
 
-ConfigFinder::ConfigFinder(const std::string &deviceName) : fileLocation{findFile(deviceName + CONFIG_SUFFIX, CONFIG_FOLDER)} {}
+namespace {
+    // one registry per config folder for the life of the process, lookups only check its directory times
+    std::mutex registriesMutex;
+    std::map<std::string, std::unique_ptr<firmware::json::config::DeviceRegistry>> registries;
+}
+
+ConfigFinder::ConfigFinder(const std::string &deviceName) : fileLocation{lookup(deviceName, CONFIG_FOLDER)} {}
 
-ConfigFinder::ConfigFinder(const std::string &deviceName, const std::filesystem::path& baseBath) : fileLocation{findFile(deviceName + CONFIG_SUFFIX, (baseBath.string()))}  {}
+ConfigFinder::ConfigFinder(const std::string &deviceName, const std::filesystem::path& baseBath) : fileLocation{lookup(deviceName, baseBath)}  {}
+
+std::filesystem::path ConfigFinder::defaultFolder() {
+    return CONFIG_FOLDER;
+}
+
+utils::expected<const fs::path, const std::string>
+ConfigFinder::lookup(const std::string &deviceName, const std::filesystem::path &folder) noexcept {
+    const utils::trace::Span span{ "config discovery", "config" };
+    try {
+        if (!fs::is_directory(folder)) {
+            std::stringstream ss;
+            ss << "Unable to Open: " << folder.string();
+            return utils::make_unexpected(ss.str());
+        }
+        const auto cacheFile = firmware::json::config::DeviceRegistry::defaultCacheFile(folder);
+        std::lock_guard lock{registriesMutex};
+        auto& registry = registries[fs::absolute(folder).lexically_normal().string()];
+        if (!registry) {
+            registry = std::make_unique<firmware::json::config::DeviceRegistry>(folder, cacheFile);
+        } else if (!registry->upToDate()) {
+            registry->rescan(cacheFile);
+        }
+        if (auto entry = registry->find(deviceName); entry && fs::exists(entry->path)) {
+            return {entry->path};
+        }
+        // a tree rebuilt within the resolution of the directory times can fool the cache
+        if (registry->loadedFromCache()) {
+            registry->rescan(cacheFile);
+            if (auto entry = registry->find(deviceName)) {
+                return {entry->path};
+            }
+        }
+    } catch (std::exception&) {
+        // fall through to the error below
+    }
+    std::stringstream ss;
+    ss << "No config for " << deviceName << " in " << folder.string();
+    return utils::make_unexpected(ss.str());
+}
 
 const utils::expected<const fs::path, const std::string>
 ConfigFinder::findFile(const std::string &filename, const std::string &folder) noexcept {
@@ -19,7 +65,9 @@ ConfigFinder::findFile(const std::string &filename, const std::string &folder) n
                 return {entry.path()};
             }
             if(entry.is_directory()) {
-                return findFile(filename, entry.path().string());
+                if (auto found = findFile(filename, entry.path().string())) {
+                    return {*found};
+                }
             }
         }
     } catch(fs::filesystem_error& err) {
@@ -27,7 +75,9 @@ ConfigFinder::findFile(const std::string &filename, const std::string &folder) n
         ss << "Unable to Open: " << folder;
         return utils::unexpected(ss.str());
     }
-    return  utils::make_unexpected("An Unknown Error occured");
+    std::stringstream ss;
+    ss << "Unable to find " << filename << " in " << folder;
+    return utils::make_unexpected(ss.str());
 }
 
 const utils::expected<const fs::path, const std::string> ConfigFinder::getFileLocation() const noexcept {
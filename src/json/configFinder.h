@@ -5,11 +5,15 @@
 #pragma once
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <iostream>
 #include  <sstream>
 #include "../utils/expected.h"
 #include "../utils/fileUtils.h"
+#include "DeviceRegistry.h"
 
 
 
@@ -19,11 +23,18 @@ private:
     static constexpr auto CONFIG_SUFFIX = ".json";
 
     utils::expected<const std::filesystem::path, const std::string> fileLocation;
+
+    [[nodiscard]] static utils::expected<const std::filesystem::path, const std::string> lookup(const std::string& deviceName, const std::filesystem::path& folder) noexcept;
 public:
     explicit ConfigFinder(const std::string& deviceName);
 
     ConfigFinder(const std::string& deviceName, const std::filesystem::path& baseBath);
 
+    /**
+     * Folder the device configs are looked up in, relative to the working directory.
+     */
+    [[nodiscard]] static std::filesystem::path defaultFolder();
+
     [[nodiscard]] const utils::expected<const std::filesystem::path, const std::string> findFile(const std::string& filename, const std::string& folder) noexcept;
 
     [[nodiscard]] const utils::expected<const std::filesystem::path, const std::string> getFileLocation() const noexcept;
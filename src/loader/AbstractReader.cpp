@@ -0,0 +1,112 @@
+//
+// Created on 15.10.26.
+//
+
+#include "AbstractReader.h"
+
+namespace firmware::reader {
+    namespace {
+        // bytes handed to the send manager between two progress updates
+        constexpr std::size_t progressChunkSize = 1024;
+    }
+
+    void AbstractReader::finishLoading(const byte& maxSize) {
+        const auto& content = image();
+        mFileSize = byte{ static_cast<long>(content.endAddress()) };
+        mStartAddress = content.startAddress();
+
+        if (mFileSize + byte{ static_cast<long>(mStartAddress) } > maxSize) {
+            std::stringstream ss;
+            ss << "Unable to write " << mFileSize << " in the available space of " << maxSize;
+            setError(ss.str());
+            return;
+        }
+        mCanWrite = true;
+    }
+
+    void AbstractReader::setError(const std::string& message) {
+        mErrorMessage = message;
+        mCanWrite = false;
+    }
+
+    void AbstractReader::writeToStream(serial::DataSendManager &manager, const ProgressCallback& progress) const {
+        if(!mCanWrite) return;
+        sendMetadata(manager);
+
+        double counter = 0;
+        for (const auto& segment : image().segments()) {
+            writeChunks(manager, segment.data, counter, static_cast<double>(mFileSize.count()), progress);
+        }
+        if (!progress) {
+            std::cout << std::endl;
+        }
+    }
+
+    void AbstractReader::writeRanges(serial::DataSendManager &manager, const TransferPlan& plan, const ProgressCallback& progress) const {
+        if(!mCanWrite) return;
+
+        const auto total = static_cast<double>(transferSize(plan));
+        double counter = 0;
+        for (const auto& range : plan) {
+            sendNumericValue(manager, static_cast<std::intmax_t>(range.address));
+            sendNumericValue(manager, static_cast<std::intmax_t>(range.data.size()));
+            writeChunks(manager, range.data, counter, total, progress);
+            // every segment header starts a new burst
+            manager.finishBurst();
+        }
+        sendNumericValue(manager, std::intmax_t{ 0 });
+        sendNumericValue(manager, std::intmax_t{ 0 });
+        if (!progress) {
+            std::cout << std::endl;
+        }
+    }
+
+    void AbstractReader::writeChunks(serial::DataSendManager &manager, std::span<const std::byte> data,
+                                     double& counter, double total, const ProgressCallback& progress) const {
+        // chunks are encoded on their own, PackBits blocks can simply be concatenated
+        const bool compressed = manager.compression() == ::serial::utils::CompressionModes::PackBits;
+        std::vector<std::byte> encoded;
+        while (!data.empty()) {
+            const auto chunk = data.first(std::min(progressChunkSize, data.size()));
+            if (compressed) {
+                encoded.clear();
+                utils::packBits(chunk, encoded);
+                manager.write(encoded);
+            } else {
+                manager.write(chunk);
+            }
+            data = data.subspan(chunk.size());
+
+            counter += static_cast<double>(chunk.size());
+            auto percent = (counter / total) * 100;
+            if (progress) {
+                progress(percent);
+            } else {
+                utils::printPercent(percent);
+            }
+        }
+    }
+
+    void AbstractReader::sendMetadata(serial::DataSendManager& manager) const {
+        auto bpb = manager.bytesPerBurst();
+        if (utils::byteMaxValue(bpb) < AbstractReader::byte{ mFileSize }.count()) {
+            std::cout << "Can't write filesize within one buffer length!" << std::endl;
+            return;
+        }
+        sendNumericValue(manager, static_cast<std::intmax_t>(mStartAddress));
+        sendNumericValue(manager, static_cast<std::intmax_t>(mFileSize));
+    }
+
+    AbstractReader::operator bool() const noexcept {
+        return mCanWrite;
+    }
+
+    const std::optional<std::string>& AbstractReader::errorMessage() const noexcept {
+        return mErrorMessage;
+    }
+
+    serial::DataSendManager &operator<<(serial::DataSendManager &sender, const AbstractReader &reader) {
+        reader.writeToStream(sender);
+        return sender;
+    }
+}
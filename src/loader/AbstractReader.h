@@ -0,0 +1,99 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <optional>
+#include <functional>
+#include "../units/Byte.h"
+#include "../utils/utils.h"
+#include "../utils/printUtils.h"
+#include "../utils/PackBits.h"
+#include "SparseImage.h"
+#include "TransferPlan.h"
+#include "DataSendManager.h"
+
+namespace firmware::reader {
+    /**
+     * Common interface of all firmware file readers. A reader loads its file
+     * into a SparseImage on construction, everything that is sent to the
+     * device is derived from that image.
+     */
+    class AbstractReader {
+    public:
+        using byte = CustomDataTypes::ComputerScience::byte;
+
+        /**
+         * Receives the transferred share of the image in percent. Without one
+         * the progress bar is printed to stdout.
+         */
+        using ProgressCallback = std::function<void(double)>;
+
+        virtual ~AbstractReader() = default;
+
+        explicit operator bool() const noexcept;
+
+        [[nodiscard]] const std::optional<std::string>& errorMessage() const noexcept;
+
+        [[nodiscard]] constexpr byte getFileSize() const noexcept { return mFileSize; }
+
+        [[nodiscard]] constexpr auto getStartAddress() const noexcept { return mStartAddress; }
+
+        [[nodiscard]] virtual const SparseImage& image() const noexcept = 0;
+
+        void writeToStream(serial::DataSendManager &manager, const ProgressCallback& progress = {}) const;
+
+        /**
+         * Sends the given parts of the image with the segmented protocol:
+         * address and length in front of every range, each range padded to
+         * full bursts, followed by an empty range as terminator.
+         */
+        void writeRanges(serial::DataSendManager &manager, const TransferPlan& plan, const ProgressCallback& progress = {}) const;
+
+        friend serial::DataSendManager& operator<<(serial::DataSendManager& sender, const AbstractReader& reader);
+
+    protected:
+        /**
+         * Takes size and start address from the loaded image and checks them
+         * against the available flash. Has to be called by the derived class
+         * once its image is complete.
+         */
+        void finishLoading(const byte& maxSize);
+
+        void setError(const std::string& message);
+
+    private:
+        void sendMetadata(serial::DataSendManager& manager) const;
+
+        void writeChunks(serial::DataSendManager &manager, std::span<const std::byte> data, double& counter, double total,
+                         const ProgressCallback& progress) const;
+
+        template<typename T>
+#ifdef __cpp_concepts
+        requires std::is_arithmetic_v<T>
+#endif
+        void sendNumericValue(firmware::serial::DataSendManager& manager, const T& value) const {
+            auto splitValue = utils::splitNumer<std::byte>(value);
+            //TODO: if gcc supports it use: std::for_each_n
+            /*std::for_each_n(std::begin(splitValue), manager.bytesPerBurst(), [&](auto& element) {
+                    manager.bufferedWrite(element);
+                });*/
+            for(std::size_t i=0; i < std::min(manager.metadataSize(), splitValue.size()); i++) {
+                manager.metadataWrite(splitValue[i]);
+            }
+            for (std::intmax_t i = 0; i < std::max(static_cast < std::intmax_t>(0), static_cast<std::intmax_t>(static_cast<std::intmax_t>(manager.metadataSize()) - static_cast<std::intmax_t>(splitValue.size()))); i++) {
+                manager.metadataWrite(std::byte(0x00));
+            }
+        }
+
+        bool mCanWrite{ false };
+        std::optional<std::string> mErrorMessage{ std::nullopt };
+        byte mFileSize{ 0 };
+        std::size_t mStartAddress{ 0 };
+    };
+}
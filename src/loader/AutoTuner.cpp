@@ -0,0 +1,161 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "AutoTuner.h"
+
+namespace firmware::serial {
+    namespace {
+        constexpr auto tuningHeader = "firmware-loader transfer tuning 2";
+        // re-running the result and, if that fails, the start parameters
+        constexpr std::size_t closingTrials = 2;
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const TransferParameters& parameters) {
+        stream << parameters.bytesPerBurst << " bytes per burst, ";
+        if (parameters.acknowledged()) {
+            return stream << "ack window " << parameters.ackWindow;
+        }
+        return stream << parameters.flashBurstDelay.count() << "ms delay";
+    }
+
+    TransferParameters transferParameters(const json::config::ResolvedDeviceConfig& config) noexcept {
+        return TransferParameters{ config.serialBytesPerBurst, std::chrono::ceil<std::chrono::milliseconds>(config.serialFlashBurstDelay),
+                                   config.serialAckByte ? std::max(config.serialAckWindow, std::size_t{ 1 }) : 0 };
+    }
+
+    json::config::ResolvedDeviceConfig withParameters(json::config::ResolvedDeviceConfig config,
+                                                      const TransferParameters& parameters) noexcept {
+        config.serialBytesPerBurst = parameters.bytesPerBurst;
+        config.serialFlashBurstDelay = parameters.flashBurstDelay;
+        if (config.serialAckByte && parameters.acknowledged()) {
+            config.serialAckWindow = parameters.ackWindow;
+        }
+        return config;
+    }
+
+    AutoTuner::AutoTuner(TransferParameters start, TuningLimits limits) : mStart{ start }, mLimits{ limits } {}
+
+    TuningResult AutoTuner::tune(const TrialFunction& trial) const {
+        TuningResult result{ mStart, {}, false };
+        const auto run = [&](const TransferParameters& parameters) {
+            result.trials.push_back(TuningTrial{ parameters, trial(parameters) });
+            return !result.trials.back().error;
+        };
+        const auto budgetLeft = [&]() { return result.trials.size() + closingTrials < mLimits.maxTrials; };
+
+        if (!run(mStart)) {
+            return result;
+        }
+        result.verified = true;
+        auto good = mStart;
+
+        // larger bursts first, each one saves a whole delay
+        while (budgetLeft() && good.bytesPerBurst * 2 <= mLimits.maxBytesPerBurst) {
+            auto candidate = good;
+            candidate.bytesPerBurst *= 2;
+            if (!run(candidate)) {
+                break;
+            }
+            good = candidate;
+        }
+
+        if (good.acknowledged()) {
+            // more bursts in flight, the delay isn't applied between acknowledged bursts
+            while (budgetLeft() && good.ackWindow * 2 <= mLimits.maxAckWindow) {
+                auto candidate = good;
+                candidate.ackWindow *= 2;
+                if (!run(candidate)) {
+                    break;
+                }
+                good = candidate;
+            }
+        } else {
+            // the shortest delay which still passes, failing is at or below low
+            auto low = mLimits.minFlashBurstDelay;
+            if (budgetLeft() && low < good.flashBurstDelay) {
+                auto candidate = good;
+                candidate.flashBurstDelay = low;
+                if (run(candidate)) {
+                    good = candidate;
+                }
+            }
+            while (budgetLeft() && good.flashBurstDelay - low > std::chrono::milliseconds{ 1 }) {
+                auto candidate = good;
+                candidate.flashBurstDelay = low + (good.flashBurstDelay - low) / 2;
+                if (run(candidate)) {
+                    good = candidate;
+                } else {
+                    low = candidate.flashBurstDelay;
+                }
+            }
+        }
+
+        // leave the device with a complete transfer of the result
+        const auto& last = result.trials.back();
+        if (last.error || last.parameters != good) {
+            if (!run(good)) {
+                good = mStart;
+                run(good);
+            }
+        }
+        result.parameters = good;
+        return result;
+    }
+
+    TuningStore::TuningStore(std::filesystem::path file) : mFile{ std::move(file) } {
+        std::ifstream stream{ mFile };
+        std::string line;
+        if (!std::getline(stream, line) || line != tuningHeader) {
+            return;
+        }
+        while (std::getline(stream, line)) {
+            std::stringstream fields{ line };
+            std::string deviceID;
+            std::string port;
+            std::size_t bytesPerBurst = 0;
+            long delay = 0;
+            std::size_t ackWindow = 0;
+            if (std::getline(fields, deviceID, '\t') && std::getline(fields, port, '\t') && fields >> bytesPerBurst >> delay >> ackWindow) {
+                mEntries[{ deviceID, port }] = TransferParameters{ bytesPerBurst, std::chrono::milliseconds{ delay }, ackWindow };
+            }
+        }
+    }
+
+    std::optional<TransferParameters> TuningStore::find(const std::string& deviceID, const std::string& port) const {
+        auto entry = mEntries.find({ deviceID, port });
+        if (entry == std::end(mEntries)) {
+            return std::nullopt;
+        }
+        return entry->second;
+    }
+
+    bool TuningStore::store(const std::string& deviceID, const std::string& port, const TransferParameters& parameters) {
+        mEntries[{ deviceID, port }] = parameters;
+        try {
+            if (mFile.has_parent_path()) {
+                std::filesystem::create_directories(mFile.parent_path());
+            }
+            auto temporaryPath = mFile;
+            temporaryPath += ".tmp";
+            {
+                std::ofstream stream{ temporaryPath, std::ios::out | std::ios::trunc };
+                stream << tuningHeader << '\n';
+                for (const auto& [key, entry] : mEntries) {
+                    stream << key.first << '\t' << key.second << '\t' << entry.bytesPerBurst << '\t'
+                           << entry.flashBurstDelay.count() << '\t' << entry.ackWindow << '\n';
+                }
+                if (!stream.good()) {
+                    return false;
+                }
+            }
+            std::filesystem::rename(temporaryPath, mFile);
+            return true;
+        } catch (std::exception&) {
+            return false;
+        }
+    }
+}
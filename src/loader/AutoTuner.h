@@ -0,0 +1,114 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../json/ConfigManager.h"
+
+namespace firmware::serial {
+    /**
+     * The options which decide how fast bursts are sent. Acknowledged
+     * transfers are paced by the acknowledgements, they never wait for
+     * the burst delay, unacknowledged ones only by the delay.
+     */
+    struct TransferParameters {
+        std::size_t bytesPerBurst;
+        std::chrono::milliseconds flashBurstDelay;
+        // bursts sent ahead of their acknowledgements, 0 if the device doesn't acknowledge
+        std::size_t ackWindow{ 0 };
+
+        bool operator==(const TransferParameters& other) const noexcept = default;
+
+        [[nodiscard]] bool acknowledged() const noexcept {
+            return ackWindow > 0;
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const TransferParameters& parameters);
+
+    [[nodiscard]] TransferParameters transferParameters(const json::config::ResolvedDeviceConfig& config) noexcept;
+
+    [[nodiscard]] json::config::ResolvedDeviceConfig withParameters(json::config::ResolvedDeviceConfig config,
+                                                                   const TransferParameters& parameters) noexcept;
+
+    struct TuningLimits {
+        std::size_t maxBytesPerBurst{ 1024 };
+        std::chrono::milliseconds minFlashBurstDelay{ 0 };
+        std::size_t maxAckWindow{ 16 };
+        // every trial is a complete transfer, including the closing ones
+        std::size_t maxTrials{ 12 };
+    };
+
+    struct TuningTrial {
+        TransferParameters parameters;
+        std::optional<std::string> error;
+    };
+
+    struct TuningResult {
+        // the fastest parameters which passed, the start parameters if none did
+        TransferParameters parameters;
+        std::vector<TuningTrial> trials;
+        // false if not even the start parameters passed
+        bool verified{ false };
+    };
+
+    /**
+     * Searches faster transfer parameters, starting from a known good set:
+     * the burst size is doubled while transfers pass, then the parameter
+     * which paces the transfer is tuned. Acknowledged transfers double the
+     * ack window, unacknowledged ones bisect the burst delay between the
+     * minimum and the last passing delay. A failed trial backs off to the
+     * last passing parameters. Only a trial which can notice a device that
+     * didn't keep up (acknowledgements, a simulator) makes the search
+     * meaningful.
+     */
+    class AutoTuner {
+    public:
+        /**
+         * Runs a complete transfer with the given parameters and returns
+         * the reason it failed, or nothing if the device accepted it.
+         */
+        using TrialFunction = std::function<std::optional<std::string>(const TransferParameters& parameters)>;
+
+        explicit AutoTuner(TransferParameters start, TuningLimits limits = {});
+
+        /**
+         * The last trial always uses the returned parameters, so if it
+         * passed, the device holds a complete transfer afterwards. Two
+         * trials of the budget are kept for that.
+         */
+        TuningResult tune(const TrialFunction& trial) const;
+
+    private:
+        TransferParameters mStart;
+        TuningLimits mLimits;
+    };
+
+    /**
+     * Tuned parameters per device and port, kept in a small text file so
+     * later runs start with the fastest known good settings.
+     */
+    class TuningStore {
+    public:
+        explicit TuningStore(std::filesystem::path file);
+
+        [[nodiscard]] std::optional<TransferParameters> find(const std::string& deviceID, const std::string& port) const;
+
+        bool store(const std::string& deviceID, const std::string& port, const TransferParameters& parameters);
+
+        static constexpr auto defaultFile = "transfer_tuning.txt";
+
+    private:
+        std::filesystem::path mFile;
+        std::map<std::pair<std::string, std::string>, TransferParameters> mEntries;
+    };
+}
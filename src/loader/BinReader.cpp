@@ -0,0 +1,27 @@
+//
+// Created on 15.10.26.
+//
+
+#include "BinReader.h"
+
+namespace firmware::reader {
+    BinReader::BinReader(const std::string &fileLocation, const byte &maxSize, SparseImage::address_type baseAddress) {
+        utils::MappedFile binaryInput{fileLocation};
+        if (!binaryInput) {
+            setError(*binaryInput.errorMessage());
+            return;
+        }
+
+        const auto content = binaryInput.view();
+        if (content.empty()) {
+            setError("Binary file is empty: " + fileLocation);
+            return;
+        }
+        mImage.append(baseAddress, std::as_bytes(std::span{ content.data(), content.size() }));
+        finishLoading(maxSize);
+    }
+
+    const SparseImage& BinReader::image() const noexcept {
+        return mImage;
+    }
+}
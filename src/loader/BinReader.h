@@ -0,0 +1,25 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <string>
+#include "../utils/MappedFile.h"
+#include "AbstractReader.h"
+
+namespace firmware::reader {
+    /**
+     * Reads a raw binary image. The file carries no addresses, so its first
+     * byte is placed at the given base address.
+     */
+    class BinReader : public AbstractReader {
+    public:
+        BinReader(const std::string &fileLocation, const byte &maxSize, SparseImage::address_type baseAddress = 0);
+
+        [[nodiscard]] const SparseImage& image() const noexcept override;
+
+    private:
+        SparseImage mImage;
+    };
+}
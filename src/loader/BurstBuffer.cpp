@@ -0,0 +1,56 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "BurstBuffer.h"
+
+namespace firmware::serial {
+    BurstBuffer::BurstBuffer(std::size_t capacity) : mStorage(capacity) {
+    }
+
+    std::size_t BurstBuffer::append(std::span<const std::byte> data) noexcept {
+        if (mTail + data.size() > capacity()) {
+            compact();
+        }
+        const auto length = std::min(data.size(), capacity() - mTail);
+        std::copy_n(std::begin(data), length, std::next(std::begin(mStorage), static_cast<std::ptrdiff_t>(mTail)));
+        mTail += length;
+        return length;
+    }
+
+    bool BurstBuffer::push_back(std::byte data) noexcept {
+        return append(std::span<const std::byte>{ &data, 1 }) == 1;
+    }
+
+    void BurstBuffer::padTo(std::size_t size, std::byte padding) noexcept {
+        while (this->size() < size && push_back(padding)) {
+        }
+    }
+
+    std::span<const std::byte> BurstBuffer::front(std::size_t length) const noexcept {
+        return std::span<const std::byte>{ mStorage }.subspan(mHead, std::min(length, size()));
+    }
+
+    void BurstBuffer::consume(std::size_t length) noexcept {
+        mHead += std::min(length, size());
+        if (mHead == mTail) {
+            clear();
+        }
+    }
+
+    void BurstBuffer::clear() noexcept {
+        mHead = 0;
+        mTail = 0;
+    }
+
+    void BurstBuffer::compact() noexcept {
+        if (mHead == 0) {
+            return;
+        }
+        std::memmove(mStorage.data(), mStorage.data() + mHead, size());
+        mTail -= mHead;
+        mHead = 0;
+    }
+}
@@ -0,0 +1,53 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <span>
+
+namespace firmware::serial {
+    /**
+     * Fixed size send buffer. Its storage is allocated once, pending bytes
+     * are always contiguous, so a burst can be handed to the serial port as
+     * a span. Consumed space at the front is reclaimed by moving the (short)
+     * remainder back to the start instead of wrapping around.
+     */
+    class BurstBuffer {
+    public:
+        explicit BurstBuffer(std::size_t capacity);
+
+        /**
+         * Copies as many bytes as fit and returns how many were taken.
+         */
+        std::size_t append(std::span<const std::byte> data) noexcept;
+
+        bool push_back(std::byte data) noexcept;
+
+        /**
+         * Fills the buffer up to the given size with a padding byte.
+         */
+        void padTo(std::size_t size, std::byte padding) noexcept;
+
+        [[nodiscard]] std::span<const std::byte> front(std::size_t length) const noexcept;
+
+        void consume(std::size_t length) noexcept;
+
+        void clear() noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept { return mTail - mHead; }
+
+        [[nodiscard]] bool empty() const noexcept { return mTail == mHead; }
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return mStorage.size(); }
+
+    private:
+        void compact() noexcept;
+
+        std::vector<std::byte> mStorage;
+        std::size_t mHead{ 0 };
+        std::size_t mTail{ 0 };
+    };
+}
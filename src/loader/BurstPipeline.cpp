@@ -0,0 +1,99 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "BurstPipeline.h"
+
+namespace firmware::serial {
+    BurstPipeline::BurstPipeline(std::size_t slotCount, std::size_t slotSize, Sender sender) :
+            mSlotSize{ slotSize },
+            mStorage(std::max(slotCount, std::size_t{ 1 }) * slotSize),
+            mLengths(std::max(slotCount, std::size_t{ 1 })),
+            mSender{ std::move(sender) },
+            mThread{ [this]() { run(); } } {
+    }
+
+    BurstPipeline::~BurstPipeline() {
+        {
+            std::lock_guard lock{ mMutex };
+            mStop = true;
+        }
+        mQueueChanged.notify_all();
+        mThread.join();
+    }
+
+    void BurstPipeline::push(std::span<const std::byte> burst) {
+        if (burst.size() > mSlotSize) {
+            throw std::length_error("Burst is larger than a pipeline slot");
+        }
+        std::unique_lock lock{ mMutex };
+        mQueueChanged.wait(lock, [this]() { return mQueued < mLengths.size() || mFailure; });
+        rethrowFailure();
+
+        const auto slot = (mHead + mQueued) % mLengths.size();
+        std::copy(std::begin(burst), std::end(burst),
+                  std::next(std::begin(mStorage), static_cast<std::ptrdiff_t>(slot * mSlotSize)));
+        mLengths[slot] = burst.size();
+        mQueued++;
+        lock.unlock();
+        mQueueChanged.notify_all();
+    }
+
+    void BurstPipeline::wait() {
+        std::unique_lock lock{ mMutex };
+        mQueueChanged.wait(lock, [this]() { return (mQueued == 0 && !mSending) || mFailure; });
+        rethrowFailure();
+    }
+
+    void BurstPipeline::reset() {
+        std::unique_lock lock{ mMutex };
+        mQueueChanged.wait(lock, [this]() { return !mSending; });
+        mQueued = 0;
+        mHead = 0;
+        if (!mFailure) {
+            return;
+        }
+        // the sender thread ends with the failed send
+        mFailure = nullptr;
+        lock.unlock();
+        mThread.join();
+        mThread = std::thread{ [this]() { run(); } };
+    }
+
+    void BurstPipeline::run() noexcept {
+        std::unique_lock lock{ mMutex };
+        while (true) {
+            mQueueChanged.wait(lock, [this]() { return mQueued > 0 || mStop; });
+            if (mQueued == 0) {
+                return;
+            }
+            // the slot stays reserved until it is sent, so it can be read unlocked
+            const std::span<const std::byte> burst{ mStorage.data() + mHead * mSlotSize, mLengths[mHead] };
+            mSending = true;
+            lock.unlock();
+            try {
+                mSender(burst);
+            } catch (...) {
+                lock.lock();
+                mFailure = std::current_exception();
+                mQueued = 0;
+                mSending = false;
+                mQueueChanged.notify_all();
+                return;
+            }
+            lock.lock();
+            mHead = (mHead + 1) % mLengths.size();
+            mQueued--;
+            mSending = false;
+            mQueueChanged.notify_all();
+        }
+    }
+
+    void BurstPipeline::rethrowFailure() {
+        if (mFailure) {
+            std::rethrow_exception(mFailure);
+        }
+    }
+}
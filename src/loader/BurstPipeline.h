@@ -0,0 +1,71 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace firmware::serial {
+    /**
+     * Hands bursts to a sender thread, so the next bursts can be prepared
+     * while the current one is on the wire. Bursts are copied into a fixed
+     * number of preallocated slots, push() only blocks while all of them
+     * are waiting to be sent.
+     */
+    class BurstPipeline {
+    public:
+        using Sender = std::function<void(std::span<const std::byte>)>;
+
+        BurstPipeline(std::size_t slotCount, std::size_t slotSize, Sender sender);
+
+        ~BurstPipeline();
+
+        BurstPipeline(const BurstPipeline&) = delete;
+
+        BurstPipeline& operator=(const BurstPipeline&) = delete;
+
+        /**
+         * Queues a burst of at most slotSize bytes. Rethrows the exception of
+         * a failed send.
+         */
+        void push(std::span<const std::byte> burst);
+
+        /**
+         * Blocks until every queued burst has been sent. Rethrows the
+         * exception of a failed send.
+         */
+        void wait();
+
+        /**
+         * Drops the queued bursts and a failure, so the pipeline can be used
+         * for the next transfer. Waits for a burst which is being sent.
+         */
+        void reset();
+
+    private:
+        void run() noexcept;
+
+        void rethrowFailure();
+
+        const std::size_t mSlotSize;
+        std::vector<std::byte> mStorage;
+        std::vector<std::size_t> mLengths;
+        std::size_t mHead{ 0 };
+        std::size_t mQueued{ 0 };
+        bool mSending{ false };
+        bool mStop{ false };
+        std::exception_ptr mFailure{ nullptr };
+        Sender mSender;
+        std::mutex mMutex;
+        std::condition_variable mQueueChanged;
+        std::thread mThread;
+    };
+}
@@ -2,36 +2,62 @@
 // Created by sebastian on 03.06.19.
 //
 
+#include <algorithm>
 #include "DataSendManager.h"
+#include "../utils/Trace.h"
 
 namespace firmware::serial {
-    DataSendManager::DataSendManager(const json::config::ConfigManager &manager, const CommunicationData& data) :
-            mSerial{data.device, data.baudrate, manager.getJSONValue<json::config::JsonOptions::serialMode>()},
-            mBytesPerBurst{ manager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>() },
-            mMetadataSize{ manager.getJSONValue<json::config::JsonOptions::serialMetadataSize>() },
-            mStartupWaitTime{ manager.getJSONValue<firmware::json::config::JsonOptions::serialWaitTimeForReset>() },
-            mManager{ std::move(manager) } {
-        // preventing odd serial behaviour. It might be possible that this
-        // can be removed later, if hw serial is disabled ?
-        //std::this_thread::sleep_for(std::chrono::milliseconds(200));
-        initialSync();
+    namespace {
+        // room for a few bursts, so bulk writes don't have to send after every copy
+        constexpr std::size_t burstsPerBuffer = 4;
+
+        std::size_t burstBufferCapacity(std::size_t bytesPerBurst, std::size_t metadataSize) noexcept {
+            return burstsPerBuffer * std::max({ bytesPerBurst, metadataSize, std::size_t{ 1 } });
+        }
+
+        json::config::ResolvedDeviceConfig resolvedConfig(const json::config::ConfigManager& manager) {
+            const auto& config = manager.resolved();
+            if (!config) {
+                throw std::runtime_error(config.error());
+            }
+            return *config;
+        }
     }
 
+    DataSendManager::DataSendManager(const json::config::ConfigManager &manager, const CommunicationData& data) :
+            DataSendManager{ resolvedConfig(manager), data } {}
+
     DataSendManager::DataSendManager(const json::config::ConfigManager& manager, const CommunicationData& data, std::chrono::milliseconds startupWaitTime) :
-        mSerial{ data.device, data.baudrate, manager.getJSONValue<json::config::JsonOptions::serialMode>() },
-        mBytesPerBurst{ manager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>() },
-        mMetadataSize{ manager.getJSONValue<json::config::JsonOptions::serialMetadataSize>() },
+            DataSendManager{ resolvedConfig(manager), data, startupWaitTime } {}
+
+    DataSendManager::DataSendManager(const json::config::ConfigManager& manager, std::unique_ptr<AbstractSerial> serialImplementation, bool startupSync) :
+            DataSendManager{ resolvedConfig(manager), std::move(serialImplementation), startupSync } {}
+
+    DataSendManager::DataSendManager(const json::config::ResolvedDeviceConfig& config, const CommunicationData& data) :
+            DataSendManager{ config, data, config.serialWaitTimeForReset } {}
+
+    DataSendManager::DataSendManager(const json::config::ResolvedDeviceConfig& config, const CommunicationData& data, std::chrono::milliseconds startupWaitTime) :
+        mConfig{ config },
+        mSerial{ data.device, data.baudrate, mConfig.serialMode },
+        mBytesPerBurst{ mConfig.serialBytesPerBurst },
+        mMetadataSize{ mConfig.serialMetadataSize },
         mStartupWaitTime{ startupWaitTime },
-        mManager{ std::move(manager) } {
+        mBuffer{ burstBufferCapacity(mBytesPerBurst, mMetadataSize) },
+        mSyncFrame{ createSyncFrame() } {
+        // preventing odd serial behaviour. It might be possible that this
+        // can be removed later, if hw serial is disabled ?
+        //std::this_thread::sleep_for(std::chrono::milliseconds(200));
         initialSync();
     }
 
-    DataSendManager::DataSendManager(const json::config::ConfigManager& manager, std::unique_ptr<AbstractSerial> serialImplementation, bool startupSync) :
+    DataSendManager::DataSendManager(const json::config::ResolvedDeviceConfig& config, std::unique_ptr<AbstractSerial> serialImplementation, bool startupSync) :
+            mConfig{ config },
             mSerial {std::move(serialImplementation)},
-            mBytesPerBurst {manager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>()},
-            mMetadataSize{ manager.getJSONValue<json::config::JsonOptions::serialMetadataSize>() },
-            mStartupWaitTime{ manager.getJSONValue<firmware::json::config::JsonOptions::serialWaitTimeForReset>() },
-            mManager{ std::move(manager) } {
+            mBytesPerBurst { mConfig.serialBytesPerBurst },
+            mMetadataSize{ mConfig.serialMetadataSize },
+            mStartupWaitTime{ mConfig.serialWaitTimeForReset },
+            mBuffer{ burstBufferCapacity(mBytesPerBurst, mMetadataSize) },
+            mSyncFrame{ createSyncFrame() } {
         if (startupSync) {
             initialSync();
         }
@@ -58,7 +84,16 @@ namespace firmware::serial {
         return mMetadataSize;
     }
 
+    ::serial::utils::CompressionModes DataSendManager::compression() const noexcept {
+        return mConfig.binaryCompression;
+    }
+
+    const json::config::ResolvedDeviceConfig& DataSendManager::config() const noexcept {
+        return mConfig;
+    }
+
     void DataSendManager::metadataWrite(std::byte data) {
+        const utils::trace::Span span{ "metadata", "transfer", 1 };
         mBuffer.push_back(data);
         while (mBuffer.size() >= metadataSize()) {
             sendBuffer(metadataSize());
@@ -66,81 +101,171 @@ namespace firmware::serial {
     }
 
     void DataSendManager::metadataWrite(const std::vector<std::byte>& data) {
-        mBuffer.insert(std::begin(mBuffer), std::begin(data), std::end(data));
-        while (mBuffer.size() >= metadataSize()) {
-            sendBuffer(metadataSize());
+        const utils::trace::Span span{ "metadata", "transfer", data.size() };
+        std::span<const std::byte> remaining{ data };
+        while (!remaining.empty()) {
+            remaining = remaining.subspan(mBuffer.append(remaining));
+            while (mBuffer.size() >= metadataSize()) {
+                sendBuffer(metadataSize());
+            }
         }
     }
 
-    void DataSendManager::bufferedWrite(const std::vector<decltype(mBuffer)::value_type>& data) {
-        mBuffer.insert(std::begin(mBuffer), std::begin(data), std::end(data));
-        while (mBuffer.size() >= bytesPerBurst()) {
-            sendBuffer();
-        }
+    void DataSendManager::bufferedWrite(const std::vector<std::byte>& data) {
+        write(data);
     }
 
     void DataSendManager::bufferedWrite(std::byte data) {
         mBuffer.push_back(data);
-        if (mBuffer.size() >= mManager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>()) {
+        if (mBuffer.size() >= mBytesPerBurst) {
             sendBuffer();
         }
     }
 
-    void DataSendManager::flush() noexcept {
-        if (mBuffer.empty()) return;
-        const auto remainingBit = mManager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>() - mBuffer.size();
-        if (remainingBit < mManager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>()) {
-            std::fill_n(std::back_inserter(mBuffer), remainingBit, mManager.getJSONValue<json::config::JsonOptions::unusedFlashByte>());
+    void DataSendManager::write(std::span<const std::byte> data) {
+        // complete a burst which was started by earlier writes
+        while (!mBuffer.empty() && !data.empty()) {
+            const auto missing = mBytesPerBurst > mBuffer.size() ? mBytesPerBurst - mBuffer.size() : 0;
+            data = data.subspan(mBuffer.append(data.first(std::min(missing, data.size()))));
+            while (mBuffer.size() >= mBytesPerBurst) {
+                sendBuffer();
+            }
+        }
+        // whole bursts are sent straight from the callers memory
+        while (data.size() >= mBytesPerBurst) {
+            sendBurst(data.first(mBytesPerBurst));
+            data = data.subspan(mBytesPerBurst);
+        }
+        mBuffer.append(data);
+    }
+
+    void DataSendManager::finishBurst() {
+        const auto remainingBit = mBytesPerBurst - mBuffer.size();
+        if (!mBuffer.empty() && remainingBit < mBytesPerBurst) {
+            mBuffer.padTo(mBuffer.size() + remainingBit, mConfig.unusedFlashByte);
             sendBuffer();
         }
     }
 
+    void DataSendManager::flush() {
+        const utils::trace::Span span{ "flush", "transfer" };
+        finishBurst();
+        if (mPipeline) {
+            mPipeline->wait();
+        }
+        while (mUnacknowledged > 0) {
+            awaitAcknowledgement();
+        }
+    }
+
+    void DataSendManager::restart() {
+        if (mPipeline) {
+            mPipeline->reset();
+        }
+        mBuffer.clear();
+        mUnacknowledged = 0;
+        initialSync();
+    }
+
+    void DataSendManager::enablePipelining(std::size_t queuedBursts) {
+        if (mPipeline) {
+            return;
+        }
+        mPipeline = std::make_unique<BurstPipeline>(queuedBursts, std::max(mBytesPerBurst, mMetadataSize),
+                [this](std::span<const std::byte> burst) { transmitBurst(burst); });
+    }
+
     void DataSendManager::sync() noexcept {
         if (mSerial.isOpen()) {
-            const auto syncBytes = mManager.getJSONValue<json::config::JsonOptions::serialSyncByteAmount>();
-            std::vector<std::byte> tmpVector;
-            tmpVector.assign(syncBytes, mManager.getJSONValue<json::config::JsonOptions::serialSyncByte>());
-            tmpVector.push_back(mManager.getJSONValue<json::config::JsonOptions::serialPreamble>());
-            mSerial.writeData(tmpVector);
+            mSerial.writeData(mSyncFrame);
         }
     }
 
+    std::vector<std::byte> DataSendManager::createSyncFrame() const {
+        const auto syncBytes = mConfig.serialSyncByteAmount;
+        std::vector<std::byte> frame(syncBytes, mConfig.serialSyncByte);
+        frame.push_back(mConfig.serialPreamble);
+        return frame;
+    }
+
     DataSendManager &operator<<(DataSendManager &parse, std::byte data) {
         parse.bufferedWrite(data);
         return parse;
     }
 
     void DataSendManager::sendBuffer() {
-        sendBuffer(static_cast<std::size_t>(mManager.getJSONValue<json::config::JsonOptions::serialBytesPerBurst>()));
+        sendBuffer(mBytesPerBurst);
     }
 
     void DataSendManager::sendBuffer(std::size_t bufferLength) {
-        std::vector<decltype(mBuffer)::value_type> tmp;
-        auto it = std::next(std::begin(mBuffer), static_cast<decltype(mBuffer)::iterator::difference_type>(bufferLength));
-        std::move(mBuffer.begin(), it, std::back_inserter(tmp));
+        const auto burst = mBuffer.front(bufferLength);
+        sendBurst(burst);
+        mBuffer.consume(burst.size());
+    }
 
-        mBuffer.erase(std::begin(mBuffer), it);
-        if (mManager.getJSONValue<json::config::JsonOptions::serialResyncAfterBurst>() && !mSynced) {
-            sync();
+    void DataSendManager::sendBurst(std::span<const std::byte> burst) {
+        if (mPipeline) {
+            mPipeline->push(burst);
+        } else {
+            transmitBurst(burst);
         }
-        mSerial.writeData(tmp);
-        //Bug: This will not wait for the transmission to be over :-/
-        auto baud = mSerial.baudrate();
-        auto bitDuration = std::chrono::duration<double, std::ratio<1>>{ 1.0 / baud };
+    }
 
-        std::this_thread::sleep_for(bitDuration * tmp.size() * 10);
-        std::this_thread::sleep_for(mManager.getJSONValue<json::config::JsonOptions::serialFlashBurstDelay>());
+    void DataSendManager::transmitBurst(std::span<const std::byte> burst) {
+        {
+            const utils::trace::Span span{ "burst", "serial", burst.size() };
+            if (mConfig.serialResyncAfterBurst && !mSynced) {
+                sync();
+            }
+            mSerial.writeData(burst);
+        }
+        if (mConfig.serialAckByte) {
+            // the device acknowledges each burst once it is programmed, up to
+            // ackWindow bursts may be sent ahead of the acknowledgements
+            mUnacknowledged++;
+            while (mUnacknowledged >= std::max(mConfig.serialAckWindow, std::size_t{ 1 })) {
+                awaitAcknowledgement();
+            }
+            return;
+        }
+        // the programming delay starts once the burst has actually left the
+        // UART, only estimate that point if the port can't report it
+        {
+            const utils::trace::Span span{ "drain", "serial", burst.size() };
+            if (!mSerial.drain()) {
+                auto baud = mSerial.baudrate();
+                auto bitDuration = std::chrono::duration<double, std::ratio<1>>{ 1.0 / baud };
+                std::this_thread::sleep_for(bitDuration * burst.size() * 10);
+            }
+        }
+        const utils::trace::Span span{ "pacing", "serial" };
+        std::this_thread::sleep_for(mConfig.serialFlashBurstDelay);
+    }
+    void DataSendManager::awaitAcknowledgement() {
+        const utils::trace::Span span{ "acknowledgement", "serial" };
+        const auto response = mSerial.reciveByteFor(mConfig.serialAckTimeout);
+        if (!response) {
+            throw std::runtime_error("Device didn't acknowledge a burst within " +
+                                     std::to_string(mConfig.serialAckTimeout.count()) + "ms");
+        }
+        if (*response != *mConfig.serialAckByte) {
+            throw std::runtime_error("Device rejected a burst (response " +
+                                     std::to_string(std::to_integer<int>(*response)) + ")");
+        }
+        mUnacknowledged--;
     }
+
     void DataSendManager::initialSync() {
         if (!mSerial.isOpen()) {
             std::cout << *mSerial.errorMessage() << std::endl;
             return;
         }
+        const utils::trace::Span span{ "initial sync", "transfer" };
         using namespace utils::printable;
         std::cout << "Waiting for " << mStartupWaitTime.count() << "ms ..." << std::endl;
         auto start = std::chrono::system_clock::now();
         while (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start) <  mStartupWaitTime) {
-            mSerial.writeData(std::byte{ mManager.getJSONValue<json::config::JsonOptions::serialSyncByte>() });
+            mSerial.writeData(std::byte{ mConfig.serialSyncByte });
         }
     }
 }
\ No newline at end of file
@@ -13,6 +13,8 @@
 #include "../serial/AbstractSerial.h"
 #include "../json/ConfigManager.h"
 #include "../utils/utils.h"
+#include "BurstBuffer.h"
+#include "BurstPipeline.h"
 
 namespace firmware::serial {
     struct CommunicationData {
@@ -28,6 +30,16 @@ namespace firmware::serial {
 
         DataSendManager(const json::config::ConfigManager& manager, std::unique_ptr <AbstractSerial> serialImplementation, bool startupSync = true);
 
+        /**
+         * Like the constructors above, but with already resolved options,
+         * e.g. with tuned burst parameters.
+         */
+        DataSendManager(const json::config::ResolvedDeviceConfig& config, const CommunicationData& data);
+
+        DataSendManager(const json::config::ResolvedDeviceConfig& config, const CommunicationData& data, std::chrono::milliseconds startupWaitTime);
+
+        DataSendManager(const json::config::ResolvedDeviceConfig& config, std::unique_ptr <AbstractSerial> serialImplementation, bool startupSync = true);
+
         //TODO: rule of 5
         //~DataSendManager();
 
@@ -39,6 +51,13 @@ namespace firmware::serial {
 
         [[nodiscard]] std::size_t metadataSize() const noexcept;
 
+        [[nodiscard]] ::serial::utils::CompressionModes compression() const noexcept;
+
+        /**
+         * The options the bursts are framed with, including tuned parameters.
+         */
+        [[nodiscard]] const json::config::ResolvedDeviceConfig& config() const noexcept;
+
         void metadataWrite(std::byte data);
 
         void metadataWrite(const std::vector<std::byte>& data);
@@ -47,7 +66,42 @@ namespace firmware::serial {
 
         void bufferedWrite(std::byte data);
 
-        void flush() noexcept;
+        /**
+         * Sends a whole block of data. Full bursts are written directly from
+         * the given memory, only an incomplete tail is kept in the buffer
+         * until the next write or flush().
+         */
+        void write(std::span<const std::byte> data);
+
+        /**
+         * Pads and sends an incomplete burst and waits until every burst has
+         * been sent and, if the device acknowledges bursts, acknowledged.
+         * Throws std::runtime_error if an acknowledgement is missing or wrong.
+         */
+        void flush();
+
+        /**
+         * Pads an incomplete burst and queues it for sending, without waiting
+         * for it like flush() does.
+         */
+        void finishBurst();
+
+        /**
+         * Starts over for the next device on a port which stays open: drops
+         * unsent data and the failure of an earlier transfer and sends sync
+         * bytes while the device resets.
+         */
+        void restart();
+
+        /**
+         * Sends all following bursts from a separate thread, so the caller
+         * can prepare the next bursts while the current one is on the wire.
+         * flush() waits until everything has been sent. The manager must not
+         * be moved afterwards.
+         */
+        void enablePipelining(std::size_t queuedBursts = defaultQueuedBursts);
+
+        static constexpr std::size_t defaultQueuedBursts = 4;
 
         friend DataSendManager &operator<<(const DataSendManager& parse, std::byte data);
 
@@ -58,15 +112,29 @@ namespace firmware::serial {
 
         void sendBuffer(std::size_t bufferLength);
 
+        void sendBurst(std::span<const std::byte> burst);
+
+        void transmitBurst(std::span<const std::byte> burst);
+
+        void awaitAcknowledgement();
+
         void initialSync();
 
-        Serial<SerialMode::TXOnly> mSerial;
-        std::deque<std::byte> mBuffer;
+        [[nodiscard]] std::vector<std::byte> createSyncFrame() const;
+
+        const json::config::ResolvedDeviceConfig mConfig;
+        // the mode only decides which calls compile, every mode opens the same port.
+        // Receiving is needed for acknowledgements, the port is only read while
+        // waiting for one, so devices without an ackByte never touch the receive side
+        Serial<SerialMode::Duplex> mSerial;
         bool mSynced = false;
         const std::size_t mBytesPerBurst;
         const std::size_t mMetadataSize;
         const std::chrono::milliseconds mStartupWaitTime;
-        const json::config::ConfigManager& mManager;
+        BurstBuffer mBuffer;
+        const std::vector<std::byte> mSyncFrame;
+        std::size_t mUnacknowledged{ 0 };
+        std::unique_ptr<BurstPipeline> mPipeline;
     };
 }
 
@@ -0,0 +1,23 @@
+//
+// Created on 15.10.26.
+//
+
+#include "FirmwareImage.h"
+
+namespace firmware::reader {
+    FirmwareImage::FirmwareImage(std::unique_ptr<const AbstractReader> reader) :
+            AbstractReader{ *reader },
+            mReader{ std::move(reader) } {
+    }
+
+    std::shared_ptr<const FirmwareImage> FirmwareImage::freeze(std::unique_ptr<const AbstractReader> reader) {
+        if (!reader) {
+            return nullptr;
+        }
+        return std::shared_ptr<const FirmwareImage>{ new FirmwareImage{ std::move(reader) } };
+    }
+
+    const SparseImage& FirmwareImage::image() const noexcept {
+        return mReader->image();
+    }
+}
@@ -0,0 +1,31 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <memory>
+#include "AbstractReader.h"
+
+namespace firmware::reader {
+    /**
+     * Loaded image which can't change anymore, shared between all senders of
+     * a transfer. It takes over the reader, so the image is neither copied
+     * nor parsed again, and every sender only holds a reference to it.
+     */
+    class FirmwareImage final : public AbstractReader {
+    public:
+        /**
+         * Freezes the image of a loaded reader, the reader state (including
+         * its error) is kept.
+         */
+        [[nodiscard]] static std::shared_ptr<const FirmwareImage> freeze(std::unique_ptr<const AbstractReader> reader);
+
+        [[nodiscard]] const SparseImage& image() const noexcept override;
+
+    private:
+        explicit FirmwareImage(std::unique_ptr<const AbstractReader> reader);
+
+        std::unique_ptr<const AbstractReader> mReader;
+    };
+}
@@ -0,0 +1,133 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include "../utils/Crc32.h"
+#include "FlashManifest.h"
+
+namespace firmware::reader {
+    namespace {
+        constexpr auto manifestHeader = "firmware-loader manifest 1";
+    }
+
+    FlashManifest::FlashManifest(const SparseImage& image, std::size_t pageSize) : mPageSize{ std::max(pageSize, std::size_t{ 1 }) } {
+        forEachPage(image, [this, &image](SparseImage::address_type page) {
+            mPages.emplace(page, pageChecksum(image, page));
+        });
+    }
+
+    std::optional<FlashManifest> FlashManifest::load(const std::filesystem::path& path) {
+        std::ifstream stream{ path };
+        std::string line;
+        if (!std::getline(stream, line) || line != manifestHeader) {
+            return std::nullopt;
+        }
+
+        FlashManifest manifest;
+        std::string key;
+        if (!(stream >> key >> manifest.mPageSize) || key != "pageSize" || manifest.mPageSize == 0) {
+            return std::nullopt;
+        }
+        SparseImage::address_type page;
+        std::uint32_t checksum;
+        while (stream >> std::hex >> page >> checksum) {
+            manifest.mPages.emplace(page, checksum);
+        }
+        if (!stream.eof()) {
+            return std::nullopt;
+        }
+        return manifest;
+    }
+
+    bool FlashManifest::store(const std::filesystem::path& path) const noexcept {
+        try {
+            std::filesystem::create_directories(path.parent_path());
+            auto temporaryPath = path;
+            temporaryPath += ".tmp";
+            {
+                std::ofstream stream{ temporaryPath, std::ios::out | std::ios::trunc };
+                stream << manifestHeader << '\n' << "pageSize " << mPageSize << '\n' << std::hex;
+                for (const auto& [page, checksum] : mPages) {
+                    stream << page << ' ' << checksum << '\n';
+                }
+                if (!stream.good()) {
+                    return false;
+                }
+            }
+            std::filesystem::rename(temporaryPath, path);
+            return true;
+        } catch (std::exception&) {
+            return false;
+        }
+    }
+
+    TransferPlan FlashManifest::changedPages(const SparseImage& image) const {
+        TransferPlan plan;
+        forEachPage(image, [this, &image, &plan](SparseImage::address_type page) {
+            auto known = mPages.find(page);
+            if (known != std::end(mPages) && known->second == pageChecksum(image, page)) {
+                return;
+            }
+            for (const auto& range : transferRange(image, page, page + mPageSize)) {
+                appendRange(plan, range);
+            }
+        });
+        return plan;
+    }
+
+    std::filesystem::path FlashManifest::location(const std::filesystem::path& directory,
+                                                  const std::string& deviceID, const std::string& port) {
+        auto name = deviceID + "_" + port;
+        std::replace_if(std::begin(name), std::end(name),
+                        [](unsigned char c) { return !std::isalnum(c) && c != '-' && c != '_'; }, '_');
+        return directory / (name + ".manifest");
+    }
+
+    std::uint32_t FlashManifest::pageChecksum(const SparseImage& image, SparseImage::address_type page) const {
+        // the offset of every run is part of the checksum, so moved data
+        // inside a partly used page changes it as well
+        std::uint32_t checksum = 0;
+        for (const auto& range : transferRange(image, page, page + mPageSize)) {
+            auto offset = static_cast<std::uint32_t>(range.address - page);
+            std::array<std::byte, 4> offsetBytes{};
+            for (auto& element : offsetBytes) {
+                element = static_cast<std::byte>(offset & 0xFF);
+                offset >>= 8;
+            }
+            checksum = utils::crc32(offsetBytes, checksum);
+            checksum = utils::crc32(range.data, checksum);
+        }
+        return checksum;
+    }
+
+    template<typename Function>
+    void FlashManifest::forEachPage(const SparseImage& image, Function function) const {
+        std::optional<SparseImage::address_type> lastPage;
+        for (const auto& segment : image.segments()) {
+            auto page = segment.address - segment.address % mPageSize;
+            // a page shared with the previous segment was visited already
+            if (lastPage && *lastPage == page) {
+                page += mPageSize;
+            }
+            for (; page < segment.endAddress(); page += mPageSize) {
+                function(page);
+                lastPage = page;
+            }
+        }
+    }
+
+    TransferPlan segmentedTransfer(const SparseImage& image, std::size_t pageSize, std::byte blank,
+                                   const std::optional<std::filesystem::path>& manifestPath) {
+        if (manifestPath) {
+            if (auto previous = FlashManifest::load(*manifestPath)) {
+                return previous->changedPages(image);
+            }
+        }
+        return elideBlankBlocks(fullTransfer(image), pageSize, blank);
+    }
+}
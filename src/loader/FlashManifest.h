@@ -0,0 +1,67 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include "SparseImage.h"
+#include "TransferPlan.h"
+
+namespace firmware::reader {
+    /**
+     * CRC-32 of every flash page an image occupies. Stored after a successful
+     * transfer, it tells the next transfer to the same device which pages
+     * are already up to date.
+     */
+    class FlashManifest {
+    public:
+        FlashManifest(const SparseImage& image, std::size_t pageSize);
+
+        [[nodiscard]] static std::optional<FlashManifest> load(const std::filesystem::path& path);
+
+        bool store(const std::filesystem::path& path) const noexcept;
+
+        /**
+         * All pages of the image which differ from this manifest, compared
+         * in pages of the size this manifest was made with.
+         */
+        [[nodiscard]] TransferPlan changedPages(const SparseImage& image) const;
+
+        [[nodiscard]] std::size_t pageSize() const noexcept { return mPageSize; }
+
+        [[nodiscard]] const std::map<SparseImage::address_type, std::uint32_t>& pages() const noexcept { return mPages; }
+
+        /**
+         * Manifest file for a device on a port, the same board may be
+         * connected to another port later, but that only costs one full
+         * transfer.
+         */
+        [[nodiscard]] static std::filesystem::path location(const std::filesystem::path& directory,
+                                                            const std::string& deviceID, const std::string& port);
+
+    private:
+        FlashManifest() = default;
+
+        [[nodiscard]] std::uint32_t pageChecksum(const SparseImage& image, SparseImage::address_type page) const;
+
+        template<typename Function>
+        void forEachPage(const SparseImage& image, Function function) const;
+
+        std::size_t mPageSize{ 1 };
+        std::map<SparseImage::address_type, std::uint32_t> mPages;
+    };
+
+    /**
+     * Plan of a segmented transfer: the pages changed since the manifest at
+     * manifestPath, or the whole image without blank pages if there is none.
+     * Delta plans keep blank pages, they still have to overwrite what the
+     * device holds.
+     */
+    [[nodiscard]] TransferPlan segmentedTransfer(const SparseImage& image, std::size_t pageSize, std::byte blank,
+                                                 const std::optional<std::filesystem::path>& manifestPath);
+}
@@ -5,70 +5,39 @@
 #include "HexReader.h"
 
 namespace firmware::reader {
-    HexReader::HexReader(const std::string &fileLocation, const HexReader::byte &maxSize) {
-        std::ifstream intelHexInput;
-        intelHexInput.open(fileLocation, std::ifstream::in);
-        if (intelHexInput.good()) {
-            intelHexInput >> hex;
-            mFileSize = HexReader::byte{static_cast<long>(hex.currentAddress())};
-            mStartAddress = (*std::begin(hex)).address;
+    HexReader::HexReader(const std::string &fileLocation, const HexReader::byte &maxSize, const ImageCache* cache) {
+        utils::MappedFile intelHexInput{fileLocation};
+        if (!intelHexInput) {
+            setError(*intelHexInput.errorMessage());
+            return;
+        }
 
-            if (mFileSize + HexReader::byte{ static_cast<long>(mStartAddress) } > maxSize) {
-                std::stringstream ss;
-                ss << "Unable to write " << mFileSize << " in the available space of " << maxSize;
-                mErrorMessage = ss.str();
+        // hashed once, a miss stores the parsed image under the same key
+        const auto key = cache != nullptr ? std::optional{ ImageCache::sourceKey(intelHexInput.view()) } : std::nullopt;
+        if (key) {
+            mCachedImage = cache->load(*key);
+            if (mCachedImage) {
+                finishLoading(maxSize);
                 return;
             }
-            if(hex.getNoErrors() > 0) {
-                std::stringstream ss;
-                ss << "There were " << hex.getNoErrors() << " errors while parsing the hex file!";
-                mErrorMessage = ss.str();
-                return;
-            }
-        } else {
-            std::stringstream ss;
-            ss << "Failed to open: " << fileLocation;
-            mErrorMessage = ss.str();
-            return;
         }
-        mCanWrite = true;
-    }
 
-    void HexReader::writeToStream(serial::DataSendManager &manager) const {
-        if(!mCanWrite) return;
-        sendMetadata(manager);
+        hex.decode(intelHexInput.view(), std::thread::hardware_concurrency());
+        finishLoading(maxSize);
 
-        double counter = 0;
-        for (/*double counter = 0;*/const auto & data : std::as_const(hex)) {
-            counter++;
-            auto percent = (counter / mFileSize.count()) * 100;
-            utils::printPercent(percent);
-
-            manager.bufferedWrite(static_cast<std::byte>(data.data));
-        }
-        std::cout << std::endl;
-    }
-
-    void HexReader::sendMetadata(serial::DataSendManager& manager) const {
-        auto bpb = manager.bytesPerBurst();
-        if (utils::byteMaxValue(bpb) < HexReader::byte{ mFileSize }.count()) {
-            std::cout << "Can't write filesize within one buffer length!" << std::endl;
+        if(*this && hex.getNoErrors() > 0) {
+            std::stringstream ss;
+            ss << "There were " << hex.getNoErrors() << " errors while parsing the hex file!";
+            setError(ss.str());
             return;
         }
-        sendNumericValue(manager, static_cast<std::intmax_t>(mStartAddress));
-        sendNumericValue(manager, static_cast<std::intmax_t>(mFileSize));
-    }
-
-    HexReader::operator bool() const noexcept {
-        return mCanWrite;
-    }
-
-    const std::optional<std::string>& HexReader::errorMessage() const noexcept {
-        return mErrorMessage;
+        // only images without errors are cached, the size check depends on the device
+        if (key && hex.getNoErrors() == 0) {
+            cache->store(*key, hex.image());
+        }
     }
 
-    serial::DataSendManager &operator<<(serial::DataSendManager &sender, const HexReader &reader) {
-        reader.writeToStream(sender);
-        return sender;
+    const SparseImage& HexReader::image() const noexcept {
+        return mCachedImage ? *mCachedImage : hex.image();
     }
 }
@@ -0,0 +1,171 @@
+//
+// Created on 15.10.26.
+//
+
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "../utils/Crc32.h"
+#include "../utils/MappedFile.h"
+#include "ImageCache.h"
+
+namespace firmware::reader {
+    namespace {
+        constexpr std::string_view cacheMagic = "FWIC";
+        constexpr std::uint32_t cacheVersion = 2;
+        constexpr std::size_t headerSize = 4 + 4 + 6 * 8 + 4;
+
+        template<typename T>
+        void writeLittleEndian(std::ostream& stream, T value) {
+            std::array<char, sizeof(T)> bytes{};
+            for (auto& element : bytes) {
+                element = static_cast<char>(value & 0xFF);
+                value = static_cast<T>(value >> 8);
+            }
+            stream.write(bytes.data(), bytes.size());
+        }
+
+        /**
+         * Reads values from an entry and remembers if it ran past its end.
+         */
+        class EntryReader {
+        public:
+            explicit EntryReader(std::string_view data) : mData{ data } {}
+
+            template<typename T>
+            T read() noexcept {
+                T value = 0;
+                if (!take(sizeof(T))) {
+                    return value;
+                }
+                for (std::size_t i = sizeof(T); i > 0; i--) {
+                    value = static_cast<T>((value << 8) | static_cast<unsigned char>(mData[mPosition - sizeof(T) + i - 1]));
+                }
+                return value;
+            }
+
+            std::string_view readBytes(std::size_t count) noexcept {
+                if (!take(count)) {
+                    return {};
+                }
+                return mData.substr(mPosition - count, count);
+            }
+
+            [[nodiscard]] bool valid() const noexcept { return mValid; }
+
+            [[nodiscard]] bool atEnd() const noexcept { return mPosition == mData.size(); }
+
+        private:
+            bool take(std::size_t count) noexcept {
+                if (!mValid || mData.size() - mPosition < count) {
+                    mValid = false;
+                    return false;
+                }
+                mPosition += count;
+                return true;
+            }
+
+            std::string_view mData;
+            std::size_t mPosition{ 0 };
+            bool mValid{ true };
+        };
+    }
+
+    ImageCache::ImageCache(std::filesystem::path directory) : mDirectory{ std::move(directory) } {
+    }
+
+    std::optional<SparseImage> ImageCache::load(const SourceKey& key) const {
+        const auto path = entryPath(key);
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error)) {
+            return std::nullopt;
+        }
+
+        utils::MappedFile entry{ path };
+        if (!entry || entry.view().size() < headerSize) {
+            return std::nullopt;
+        }
+
+        EntryReader reader{ entry.view() };
+        if (reader.readBytes(cacheMagic.size()) != cacheMagic || reader.read<std::uint32_t>() != cacheVersion) {
+            return std::nullopt;
+        }
+        // the hash only names the file, the CRC makes sure this really is the same source
+        if (reader.read<std::uint64_t>() != key.size || reader.read<std::uint64_t>() != key.hash ||
+            reader.read<std::uint32_t>() != key.crc) {
+            return std::nullopt;
+        }
+        const auto startAddress = reader.read<std::uint64_t>();
+        const auto size = reader.read<std::uint64_t>();
+        const auto segmentCount = reader.read<std::uint64_t>();
+
+        SparseImage image;
+        for (std::uint64_t i = 0; i < segmentCount && reader.valid(); i++) {
+            const auto address = reader.read<std::uint64_t>();
+            const auto length = reader.read<std::uint64_t>();
+            const auto data = reader.readBytes(length);
+            if (!reader.valid() || !image.append(address, std::as_bytes(std::span{ data.data(), data.size() }))) {
+                return std::nullopt;
+            }
+        }
+
+        if (!reader.valid() || !reader.atEnd() || image.size() != size || image.startAddress() != startAddress) {
+            return std::nullopt;
+        }
+        return image;
+    }
+
+    bool ImageCache::store(const SourceKey& key, const SparseImage& image) const noexcept {
+        try {
+            std::filesystem::create_directories(mDirectory);
+            const auto path = entryPath(key);
+            auto temporaryPath = path;
+            temporaryPath += ".tmp";
+            {
+                std::ofstream stream{ temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc };
+                stream.write(cacheMagic.data(), cacheMagic.size());
+                writeLittleEndian<std::uint32_t>(stream, cacheVersion);
+                writeLittleEndian<std::uint64_t>(stream, key.size);
+                writeLittleEndian<std::uint64_t>(stream, key.hash);
+                writeLittleEndian<std::uint32_t>(stream, key.crc);
+                writeLittleEndian<std::uint64_t>(stream, image.startAddress());
+                writeLittleEndian<std::uint64_t>(stream, image.size());
+                writeLittleEndian<std::uint64_t>(stream, image.segments().size());
+                for (const auto& segment : image.segments()) {
+                    writeLittleEndian<std::uint64_t>(stream, segment.address);
+                    writeLittleEndian<std::uint64_t>(stream, segment.data.size());
+                    stream.write(reinterpret_cast<const char*>(segment.data.data()),
+                                 static_cast<std::streamsize>(segment.data.size()));
+                }
+                if (!stream.good()) {
+                    std::filesystem::remove(temporaryPath);
+                    return false;
+                }
+            }
+            std::filesystem::rename(temporaryPath, path);
+            return true;
+        } catch (std::exception&) {
+            return false;
+        }
+    }
+
+    std::filesystem::path ImageCache::entryPath(const SourceKey& key) const {
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << key.hash << ".img";
+        return mDirectory / ss.str();
+    }
+
+    ImageCache::SourceKey ImageCache::sourceKey(std::string_view content) noexcept {
+        // 64 bit FNV-1a and CRC-32 in the same pass over the content
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        std::uint32_t crc = ~std::uint32_t{ 0 };
+        for (const auto c : content) {
+            const auto value = static_cast<unsigned char>(c);
+            hash ^= value;
+            hash *= 0x100000001b3ULL;
+            crc = utils::detail::crc32Table[(crc ^ value) & 0xFF] ^ (crc >> 8);
+        }
+        return SourceKey{ content.size(), hash, ~crc };
+    }
+}
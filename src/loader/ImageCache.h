@@ -0,0 +1,62 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include "SparseImage.h"
+
+namespace firmware::reader {
+    /**
+     * On-disk cache of parsed firmware images. Entries are keyed by a hash of
+     * the source file content, so a changed source simply misses the cache.
+     *
+     * Entry layout (little endian):
+     *   magic "FWIC", u32 version, u64 source size, u64 source hash,
+     *   u32 source CRC-32, u64 start address, u64 byte count, u64 segment
+     *   count, then per segment u64 address, u64 length and the raw bytes.
+     */
+    class ImageCache {
+    public:
+        /**
+         * Identifies a source content. The hash names the entry, the CRC is
+         * independent of it and catches two sources with the same hash.
+         */
+        struct SourceKey {
+            std::uint64_t size;
+            std::uint64_t hash;
+            std::uint32_t crc;
+        };
+
+        explicit ImageCache(std::filesystem::path directory);
+
+        /**
+         * Returns the cached image of the source with the given key, or
+         * nothing if there is no valid entry for it. The segments are copied
+         * out of the mapped entry, a hit saves the parse, not that copy.
+         */
+        [[nodiscard]] std::optional<SparseImage> load(const SourceKey& key) const;
+
+        /**
+         * Stores the image of the source with the given key. The entry is
+         * written to a temporary file first, so readers never see partial
+         * entries.
+         */
+        bool store(const SourceKey& key, const SparseImage& image) const noexcept;
+
+        [[nodiscard]] std::filesystem::path entryPath(const SourceKey& key) const;
+
+        /**
+         * Hashes the content in a single pass, compute it once per source
+         * and pass it to load() and store().
+         */
+        [[nodiscard]] static SourceKey sourceKey(std::string_view content) noexcept;
+
+    private:
+        std::filesystem::path mDirectory;
+    };
+}
@@ -0,0 +1,114 @@
+//
+// Created on 15.10.26.
+//
+
+#include <sstream>
+#include <thread>
+#include "MultiPortFlasher.h"
+#include "FlashManifest.h"
+#include "../utils/fileUtils.h"
+
+namespace firmware::serial {
+    MultiPortFlasher::MultiPortFlasher(std::shared_ptr<const reader::FirmwareImage> image, ConnectFunction connect) :
+            mImage{ std::move(image) },
+            mConnect{ std::move(connect) } {
+    }
+
+    void MultiPortFlasher::enablePipelining() noexcept {
+        mPipelined = true;
+    }
+
+    void MultiPortFlasher::setManifestDirectory(const std::filesystem::path& directory) {
+        mManifestDirectory = directory;
+    }
+
+    std::vector<PortResult> MultiPortFlasher::flash(const std::vector<std::string>& ports,
+                                                    const ProgressCallback& progress) const {
+        std::vector<PortResult> results(ports.size());
+        std::vector<std::thread> workers;
+        workers.reserve(ports.size());
+        for (std::size_t i = 0; i < ports.size(); i++) {
+            // every sender keeps its own reference to the image
+            workers.emplace_back([this, image = mImage, &ports, &results, &progress, i]() {
+                results[i] = flashPort(*image, ports[i], [&progress, i](double percent) {
+                    if (progress) {
+                        progress(i, percent);
+                    }
+                });
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return results;
+    }
+
+    PortResult MultiPortFlasher::flashPort(const reader::FirmwareImage& firmware, const std::string& port,
+                                           const reader::AbstractReader::ProgressCallback& progress) const {
+        const auto start = std::chrono::steady_clock::now();
+        PortResult result{ port };
+        try {
+            auto manager = mConnect(port);
+            if (!manager || !manager->isOpen()) {
+                result.error = manager && manager->errorMessage() ? *manager->errorMessage() : "Unable to open the port";
+                return result;
+            }
+            if (mPipelined) {
+                manager->enablePipelining();
+            }
+            result = flashImage(*manager, firmware, port, mManifestDirectory, progress);
+        } catch (std::exception& e) {
+            result.error = e.what();
+        }
+        // opening the port and the startup sync are part of the time of a board
+        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        return result;
+    }
+
+    PortResult flashImage(DataSendManager& manager, const reader::FirmwareImage& firmware, const std::string& port,
+                          const std::optional<std::filesystem::path>& manifestDirectory,
+                          const reader::AbstractReader::ProgressCallback& progress) {
+        PortResult result{ port };
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            const auto& config = manager.config();
+            const auto& image = firmware.image();
+            std::optional<std::filesystem::path> manifestPath;
+            if (config.binaryTransfer == ::serial::utils::TransferModes::Segmented) {
+                if (manifestDirectory) {
+                    manifestPath = reader::FlashManifest::location(*manifestDirectory, config.deviceID, port);
+                }
+                const auto plan = reader::segmentedTransfer(image, config.flashPageSize(), config.unusedFlashByte, manifestPath);
+                firmware.writeRanges(manager, plan, progress);
+                result.bytes = reader::transferSize(plan);
+            } else {
+                firmware.writeToStream(manager, progress);
+                result.bytes = image.size();
+            }
+            manager.flush();
+
+            if (manifestPath && !reader::FlashManifest{ image, config.flashPageSize() }.store(*manifestPath)) {
+                result.error = "Unable to store the flash manifest " + manifestPath->string();
+            }
+        } catch (std::exception& e) {
+            result.error = e.what();
+        }
+        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        return result;
+    }
+
+    std::vector<std::string> expandPorts(const std::string& ports) {
+        std::vector<std::string> expanded;
+        std::stringstream stream{ ports };
+        std::string entry;
+        while (std::getline(stream, entry, ',')) {
+            if (entry.empty()) {
+                continue;
+            }
+            for (auto& port : utils::expandGlob(entry)) {
+                expanded.push_back(std::move(port));
+            }
+        }
+        return expanded;
+    }
+}
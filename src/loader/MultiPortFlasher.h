@@ -0,0 +1,88 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "FirmwareImage.h"
+#include "DataSendManager.h"
+
+namespace firmware::serial {
+    struct PortResult {
+        std::string port;
+        std::optional<std::string> error{ std::nullopt };
+        std::size_t bytes{ 0 };
+        std::chrono::milliseconds duration{ 0 };
+
+        explicit operator bool() const noexcept {
+            return !error;
+        }
+    };
+
+    /**
+     * Flashes one image to several devices of the same type at once, every
+     * port gets its own thread and send manager. All of them share the same
+     * frozen image, the options of a port are those of its send manager.
+     */
+    class MultiPortFlasher {
+    public:
+        /**
+         * Opens the send manager of a port, called from the thread of that port.
+         */
+        using ConnectFunction = std::function<std::unique_ptr<DataSendManager>(const std::string& port)>;
+
+        /**
+         * Progress of the port with the given index in percent, called from
+         * the thread of that port.
+         */
+        using ProgressCallback = std::function<void(std::size_t port, double percent)>;
+
+        MultiPortFlasher(std::shared_ptr<const reader::FirmwareImage> image, ConnectFunction connect);
+
+        void enablePipelining() noexcept;
+
+        /**
+         * Keeps a flash manifest per port in this directory, segmented
+         * devices only get their changed pages then.
+         */
+        void setManifestDirectory(const std::filesystem::path& directory);
+
+        /**
+         * Blocks until every port is done, the results are in port order.
+         */
+        [[nodiscard]] std::vector<PortResult> flash(const std::vector<std::string>& ports,
+                                                    const ProgressCallback& progress) const;
+
+    private:
+        [[nodiscard]] PortResult flashPort(const reader::FirmwareImage& image, const std::string& port,
+                                           const reader::AbstractReader::ProgressCallback& progress) const;
+
+        std::shared_ptr<const reader::FirmwareImage> mImage;
+        ConnectFunction mConnect;
+        bool mPipelined{ false };
+        std::optional<std::filesystem::path> mManifestDirectory{ std::nullopt };
+    };
+
+    /**
+     * Sends a frozen image over an open send manager and flushes it, with
+     * the options the manager frames its bursts with. The manifest directory
+     * is only used for segmented devices.
+     */
+    [[nodiscard]] PortResult flashImage(DataSendManager& manager, const reader::FirmwareImage& firmware,
+                                        const std::string& port,
+                                        const std::optional<std::filesystem::path>& manifestDirectory,
+                                        const reader::AbstractReader::ProgressCallback& progress);
+
+    /**
+     * Ports of a comma separated list, entries with wildcards in their file
+     * name (e.g. /dev/ttyUSB*) are expanded to all matching devices.
+     */
+    [[nodiscard]] std::vector<std::string> expandPorts(const std::string& ports);
+}
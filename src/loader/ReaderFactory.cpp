@@ -0,0 +1,49 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include <cctype>
+#include "ReaderFactory.h"
+#include "HexReader.h"
+#include "BinReader.h"
+#include "SRecReader.h"
+
+namespace firmware::reader {
+    ::serial::utils::BinaryFormats formatFromFile(const std::filesystem::path& file,
+                                                  ::serial::utils::BinaryFormats fallback) noexcept {
+        using ::serial::utils::BinaryFormats;
+        auto extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (extension == ".hex" || extension == ".ihx") {
+            return BinaryFormats::IntelHex;
+        }
+        if (extension == ".bin") {
+            return BinaryFormats::RawBinary;
+        }
+        if (extension == ".srec" || extension == ".s19" || extension == ".s28" || extension == ".s37" || extension == ".mot") {
+            return BinaryFormats::SRecord;
+        }
+        return fallback;
+    }
+
+    std::unique_ptr<AbstractReader> makeReader(::serial::utils::BinaryFormats format,
+                                               const std::string& fileLocation,
+                                               const AbstractReader::byte& maxSize,
+                                               SparseImage::address_type baseAddress,
+                                               const ImageCache* cache) {
+        using ::serial::utils::BinaryFormats;
+        switch (format) {
+            case BinaryFormats::IntelHex:
+                return std::make_unique<HexReader>(fileLocation, maxSize, cache);
+            case BinaryFormats::RawBinary:
+                return std::make_unique<BinReader>(fileLocation, maxSize, baseAddress);
+            case BinaryFormats::SRecord:
+                return std::make_unique<SRecReader>(fileLocation, maxSize);
+            default:
+                return nullptr;
+        }
+    }
+}
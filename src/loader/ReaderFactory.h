@@ -0,0 +1,33 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <filesystem>
+#include "../utils/SerialUtils.h"
+#include "AbstractReader.h"
+#include "ImageCache.h"
+
+namespace firmware::reader {
+    /**
+     * Picks the format from the file extension (.hex, .ihx, .bin, .srec,
+     * .s19, .s28, .s37, .mot) and falls back to the configured one for
+     * unknown extensions.
+     */
+    [[nodiscard]] ::serial::utils::BinaryFormats formatFromFile(const std::filesystem::path& file,
+                                                                ::serial::utils::BinaryFormats fallback) noexcept;
+
+    /**
+     * Creates the reader for the given format, nullptr for unknown formats.
+     * The base address is only used by formats without address information,
+     * the cache only by Intel HEX files.
+     */
+    [[nodiscard]] std::unique_ptr<AbstractReader> makeReader(::serial::utils::BinaryFormats format,
+                                                             const std::string& fileLocation,
+                                                             const AbstractReader::byte& maxSize,
+                                                             SparseImage::address_type baseAddress = 0,
+                                                             const ImageCache* cache = nullptr);
+}
@@ -0,0 +1,193 @@
+//
+// Created on 15.10.26.
+//
+
+#include <array>
+#include <cctype>
+#include <sstream>
+#include "SRecReader.h"
+
+namespace firmware::reader {
+    namespace {
+        constexpr unsigned char invalidNibble = 0xFF;
+
+        constexpr unsigned char hexNibble(char c) noexcept {
+            if (c >= '0' && c <= '9') return static_cast<unsigned char>(c - '0');
+            if (c >= 'A' && c <= 'F') return static_cast<unsigned char>(c - 'A' + 10);
+            if (c >= 'a' && c <= 'f') return static_cast<unsigned char>(c - 'a' + 10);
+            return invalidNibble;
+        }
+
+        // number of address bytes of every record type, 0 marks reserved types
+        constexpr std::array<std::size_t, 10> addressLength{ 2, 2, 3, 4, 0, 2, 3, 4, 3, 2 };
+
+        // the count byte and the at most 255 bytes it counts (address, data and checksum)
+        constexpr std::size_t maxRecordBytes = 1 + 255;
+
+        std::string hexString(unsigned long value) {
+            std::stringstream ss;
+            ss << std::uppercase << std::hex << value;
+            return ss.str();
+        }
+    }
+
+    SRecReader::SRecReader(const std::string &fileLocation, const byte &maxSize) {
+        utils::MappedFile srecInput{fileLocation};
+        if (!srecInput) {
+            setError(*srecInput.errorMessage());
+            return;
+        }
+
+        decode(srecInput.view());
+        mImage.coalesce();
+        finishLoading(maxSize);
+
+        if (*this && mErrors > 0) {
+            std::stringstream ss;
+            ss << "There were " << mErrors << " errors while parsing the S-record file! " << *mFirstError;
+            setError(ss.str());
+        }
+    }
+
+    const SparseImage& SRecReader::image() const noexcept {
+        return mImage;
+    }
+
+    std::optional<SparseImage::address_type> SRecReader::executionAddress() const noexcept {
+        return mExecutionAddress;
+    }
+
+    std::size_t SRecReader::getNoErrors() const noexcept {
+        return mErrors;
+    }
+
+    void SRecReader::decode(std::string_view content) {
+        std::size_t lineCounter = 0;
+        while (!content.empty()) {
+            const auto lineEnd = content.find('\n');
+            auto line = content.substr(0, lineEnd);
+            content.remove_prefix(lineEnd == std::string_view::npos ? content.size() : lineEnd + 1);
+            lineCounter++;
+
+            while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+                line.remove_suffix(1);
+            }
+            if (line.empty()) {
+                continue;
+            }
+            decodeRecord(line, lineCounter);
+        }
+    }
+
+    void SRecReader::decodeRecord(std::string_view line, std::size_t lineCounter) {
+        if (line.size() < 4 || line[0] != 'S' || line[1] < '0' || line[1] > '9') {
+            addError("Line doesn't start with an S-record type", lineCounter);
+            return;
+        }
+        const auto type = static_cast<std::size_t>(line[1] - '0');
+        line.remove_prefix(2);
+
+        if (line.size() % 2 != 0 || line.size() / 2 > maxRecordBytes) {
+            addError("Invalid record length", lineCounter);
+            return;
+        }
+
+        std::array<unsigned char, maxRecordBytes> record{};
+        const auto recordSize = line.size() / 2;
+        unsigned int checksum = 0;
+        for (std::size_t i = 0; i < recordSize; i++) {
+            const auto high = hexNibble(line[2 * i]);
+            const auto low = hexNibble(line[2 * i + 1]);
+            if (high == invalidNibble || low == invalidNibble) {
+                addError("Invalid hex character", lineCounter);
+                return;
+            }
+            record[i] = static_cast<unsigned char>((high << 4) | low);
+            checksum += record[i];
+        }
+
+        // the count covers address, data and checksum
+        if (record[0] + 1u != recordSize) {
+            addError("Byte count doesn't match line length", lineCounter);
+            return;
+        }
+        if ((checksum & 0xFF) != 0xFF) {
+            addError("Checksum error", lineCounter);
+            return;
+        }
+
+        const auto addressBytes = addressLength[type];
+        if (addressBytes == 0 || record[0] < addressBytes + 1) {
+            addError("Unsupported or truncated record type S" + std::to_string(type), lineCounter);
+            return;
+        }
+
+        SparseImage::address_type address = 0;
+        for (std::size_t i = 1; i <= addressBytes; i++) {
+            address = (address << 8) | record[i];
+        }
+        const auto data = std::as_bytes(std::span{ record }).subspan(1 + addressBytes, record[0] - addressBytes - 1);
+
+        switch (type) {
+            case 1:
+            case 2:
+            case 3:
+                mDataRecords++;
+                // records are usually in ascending order, fall back to single bytes otherwise.
+                // Overlaps are reported per byte like in Intel HEX files: the same value
+                // again is a warning, another value an error which keeps the first one
+                if (!mImage.append(address, data)) {
+                    for (const auto value : data) {
+                        const auto result = mImage.insert(address, value);
+                        if (result == SparseImage::InsertResult::Duplicate) {
+                            addWarning("Location 0x" + hexString(address) + " already contains data 0x" +
+                                       hexString(std::to_integer<unsigned long>(value)), lineCounter);
+                        } else if (result == SparseImage::InsertResult::Conflict) {
+                            addError("Couldn't add 0x" + hexString(std::to_integer<unsigned long>(value)) + " @ 0x" +
+                                     hexString(address) + "; already contains 0x" +
+                                     hexString(std::to_integer<unsigned long>(*mImage.at(address))), lineCounter);
+                        }
+                        address++;
+                    }
+                }
+                break;
+            case 5:
+            case 6:
+                if (address != mDataRecords) {
+                    addError("Record count doesn't match the number of data records", lineCounter);
+                }
+                break;
+            case 7:
+            case 8:
+            case 9:
+                mExecutionAddress = address;
+                break;
+            default:
+                // S0 carries a free form header
+                break;
+        }
+    }
+
+    std::size_t SRecReader::getNoWarnings() const noexcept {
+        return mWarnings.size();
+    }
+
+    const std::vector<std::string>& SRecReader::warnings() const noexcept {
+        return mWarnings;
+    }
+
+    void SRecReader::addWarning(const std::string& message, std::size_t lineCounter) {
+        std::stringstream ss;
+        ss << message << " @ line " << lineCounter;
+        mWarnings.push_back(ss.str());
+    }
+
+    void SRecReader::addError(const std::string& message, std::size_t lineCounter) {
+        if (!mFirstError) {
+            std::stringstream ss;
+            ss << message << " @ line " << lineCounter;
+            mFirstError = ss.str();
+        }
+        mErrors++;
+    }
+}
@@ -0,0 +1,57 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include "../utils/MappedFile.h"
+#include "AbstractReader.h"
+
+namespace firmware::reader {
+    /**
+     * Reads Motorola S-record files with 16, 24 or 32 bit addresses
+     * (S19, S28 and S37). Header and record count records are checked but
+     * otherwise ignored.
+     */
+    class SRecReader : public AbstractReader {
+    public:
+        SRecReader(const std::string &fileLocation, const byte &maxSize);
+
+        [[nodiscard]] const SparseImage& image() const noexcept override;
+
+        /**
+         * Execution start address from the S7, S8 or S9 termination record,
+         * if the file contains one.
+         */
+        [[nodiscard]] std::optional<SparseImage::address_type> executionAddress() const noexcept;
+
+        [[nodiscard]] std::size_t getNoErrors() const noexcept;
+
+        [[nodiscard]] std::size_t getNoWarnings() const noexcept;
+
+        /**
+         * Data which was given again with the same value, each with its line.
+         */
+        [[nodiscard]] const std::vector<std::string>& warnings() const noexcept;
+
+    private:
+        void decode(std::string_view content);
+
+        void decodeRecord(std::string_view line, std::size_t lineCounter);
+
+        void addWarning(const std::string& message, std::size_t lineCounter);
+
+        void addError(const std::string& message, std::size_t lineCounter);
+
+        SparseImage mImage;
+        std::optional<SparseImage::address_type> mExecutionAddress{ std::nullopt };
+        std::size_t mDataRecords{ 0 };
+        std::vector<std::string> mWarnings;
+        std::size_t mErrors{ 0 };
+        std::optional<std::string> mFirstError{ std::nullopt };
+    };
+}
@@ -0,0 +1,160 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include "SparseImage.h"
+
+namespace firmware::reader {
+    const SparseImage::const_iterator& SparseImage::const_iterator::operator++() {
+        const auto& segments = mImage->mSegments;
+        if (++mOffset >= segments[mSegment].data.size()) {
+            mOffset = 0;
+            if (++mSegment >= segments.size()) {
+                mSegment = npos;
+            }
+        }
+        return *this;
+    }
+
+    const SparseImage::const_iterator& SparseImage::const_iterator::operator--() {
+        const auto& segments = mImage->mSegments;
+        if (mSegment == npos) {
+            mSegment = segments.size() - 1;
+            mOffset = segments[mSegment].data.size() - 1;
+        } else if (mOffset == 0) {
+            --mSegment;
+            mOffset = segments[mSegment].data.size() - 1;
+        } else {
+            --mOffset;
+        }
+        return *this;
+    }
+
+    SparseImage::Element SparseImage::const_iterator::operator*() const {
+        const auto& segment = mImage->mSegments[mSegment];
+        return Element{ segment.address + static_cast<address_type>(mOffset), segment.data[mOffset] };
+    }
+
+    SparseImage::InsertResult SparseImage::insert(address_type address, std::byte data) {
+        // records are almost always in ascending order, so try the tail first
+        if (!mSegments.empty() && mSegments.back().endAddress() == address) {
+            mSegments.back().data.push_back(data);
+            ++mSize;
+            return InsertResult::Inserted;
+        }
+
+        auto next = std::upper_bound(std::begin(mSegments), std::end(mSegments), address,
+                [](address_type value, const Segment& segment) { return value < segment.address; });
+
+        if (next != std::begin(mSegments)) {
+            auto previous = std::prev(next);
+            if (address < previous->endAddress()) {
+                const auto existing = previous->data[address - previous->address];
+                return existing == data ? InsertResult::Duplicate : InsertResult::Conflict;
+            }
+            if (address == previous->endAddress()) {
+                previous->data.push_back(data);
+                ++mSize;
+                joinFollowing(previous);
+                return InsertResult::Inserted;
+            }
+        }
+
+        // a byte in front of a run starts a run of its own, prepending it would shift the whole run
+        joinFollowing(mSegments.insert(next, Segment{ address, { data } }));
+        ++mSize;
+        return InsertResult::Inserted;
+    }
+
+    bool SparseImage::append(address_type address, std::span<const std::byte> data) {
+        if (!mSegments.empty() && address < mSegments.back().endAddress()) {
+            return false;
+        }
+        if (data.empty()) {
+            return true;
+        }
+
+        if (!mSegments.empty() && address == mSegments.back().endAddress()) {
+            auto& tail = mSegments.back().data;
+            tail.insert(std::end(tail), std::begin(data), std::end(data));
+        } else {
+            mSegments.push_back(Segment{ address, { std::begin(data), std::end(data) } });
+        }
+        mSize += data.size();
+        return true;
+    }
+
+    std::optional<std::byte> SparseImage::at(address_type address) const noexcept {
+        auto segment = segmentContaining(address);
+        if (segment == std::end(mSegments)) {
+            return std::nullopt;
+        }
+        return segment->data[address - segment->address];
+    }
+
+    SparseImage::const_iterator SparseImage::find(address_type address) const noexcept {
+        auto segment = segmentContaining(address);
+        if (segment == std::end(mSegments)) {
+            return end();
+        }
+        return const_iterator{ this, static_cast<std::size_t>(std::distance(std::begin(mSegments), segment)),
+                               address - segment->address };
+    }
+
+    SparseImage::const_iterator SparseImage::rebind(const const_iterator& position) const noexcept {
+        return const_iterator{ this, position.mSegment, position.mOffset };
+    }
+
+    SparseImage::address_type SparseImage::startAddress() const noexcept {
+        return mSegments.empty() ? 0 : mSegments.front().address;
+    }
+
+    SparseImage::address_type SparseImage::endAddress() const noexcept {
+        return mSegments.empty() ? 0 : mSegments.back().endAddress();
+    }
+
+    void SparseImage::coalesce() {
+        if (mSegments.empty()) {
+            return;
+        }
+        auto joined = std::begin(mSegments);
+        for (auto segment = std::next(joined); segment != std::end(mSegments); ++segment) {
+            if (segment->address == joined->endAddress()) {
+                joined->data.insert(std::end(joined->data), std::begin(segment->data), std::end(segment->data));
+            } else if (++joined != segment) {
+                *joined = std::move(*segment);
+            }
+        }
+        mSegments.erase(std::next(joined), std::end(mSegments));
+    }
+
+    void SparseImage::clear() noexcept {
+        mSegments.clear();
+        mSize = 0;
+    }
+
+    SparseImage::const_iterator SparseImage::begin() const noexcept {
+        return mSegments.empty() ? end() : const_iterator{ this, 0, 0 };
+    }
+
+    void SparseImage::joinFollowing(std::vector<Segment>::iterator segment) {
+        // only runs which aren't larger than the growing one are joined, so every byte is copied a
+        // logarithmic number of times even if the runs arrive in descending order
+        for (auto next = std::next(segment); next != std::end(mSegments) && next->address == segment->endAddress()
+                && next->data.size() <= segment->data.size(); next = std::next(segment)) {
+            segment->data.insert(std::end(segment->data), std::begin(next->data), std::end(next->data));
+            mSegments.erase(next);
+        }
+    }
+
+    std::vector<SparseImage::Segment>::const_iterator SparseImage::segmentContaining(address_type address) const noexcept {
+        auto next = std::upper_bound(std::begin(mSegments), std::end(mSegments), address,
+                [](address_type value, const Segment& segment) { return value < segment.address; });
+        if (next == std::begin(mSegments)) {
+            return std::end(mSegments);
+        }
+        auto segment = std::prev(next);
+        return address < segment->endAddress() ? segment : std::end(mSegments);
+    }
+}
@@ -0,0 +1,131 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <span>
+#include <iterator>
+#include <optional>
+#include <limits>
+
+namespace firmware::reader {
+    /**
+     * Firmware image made of sorted, non-overlapping runs of contiguous bytes.
+     * Adjacent runs are merged on insertion unless that would copy a larger
+     * run, the rest is merged by coalesce(). A coalesced gapless image is a
+     * single vector and iterating it is a linear memory walk.
+     */
+    class SparseImage {
+    public:
+        using address_type = unsigned long;
+
+        struct Segment {
+            address_type address;
+            std::vector<std::byte> data;
+
+            [[nodiscard]] address_type endAddress() const noexcept {
+                return address + static_cast<address_type>(data.size());
+            }
+        };
+
+        struct Element {
+            const address_type address;
+            const std::byte data;
+        };
+
+        enum class InsertResult {
+            Inserted,
+            Duplicate,
+            Conflict
+        };
+
+        /**
+         * Bidirectional iterator over every stored byte. The end iterator stays
+         * valid across insertions, all other iterators are invalidated by them.
+         */
+        class const_iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = Element;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Element*;
+            using reference = Element;
+
+            const_iterator() = default;
+
+            const const_iterator& operator++();
+            const const_iterator operator++(int) { const_iterator retval = *this; ++(*this); return retval; }
+            const const_iterator& operator--();
+            const const_iterator operator--(int) { const_iterator retval = *this; --(*this); return retval; }
+            bool operator==(const const_iterator& other) const noexcept {
+                return mImage == other.mImage && mSegment == other.mSegment && mOffset == other.mOffset;
+            }
+            bool operator!=(const const_iterator& other) const noexcept { return !(*this == other); }
+            Element operator*() const;
+
+        private:
+            friend class SparseImage;
+            static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            const_iterator(const SparseImage* image, std::size_t segment, std::size_t offset) noexcept
+                : mImage{image}, mSegment{segment}, mOffset{offset} {}
+
+            const SparseImage* mImage{ nullptr };
+            std::size_t mSegment{ npos };
+            std::size_t mOffset{ 0 };
+        };
+
+        InsertResult insert(address_type address, std::byte data);
+
+        /**
+         * Appends a whole run of bytes if it starts at or behind the end of the
+         * image. Returns false without touching the image otherwise.
+         */
+        bool append(address_type address, std::span<const std::byte> data);
+
+        /**
+         * Merges the adjacent runs insert() left apart. Readers call it once
+         * they have inserted everything, it invalidates all iterators but the
+         * end iterator.
+         */
+        void coalesce();
+
+        [[nodiscard]] std::optional<std::byte> at(address_type address) const noexcept;
+
+        [[nodiscard]] const_iterator find(address_type address) const noexcept;
+
+        /**
+         * Returns an iterator to the same position inside this image, used by
+         * owners of a stored iterator when they are copied.
+         */
+        [[nodiscard]] const_iterator rebind(const const_iterator& position) const noexcept;
+
+        [[nodiscard]] const std::vector<Segment>& segments() const noexcept { return mSegments; }
+
+        [[nodiscard]] std::size_t size() const noexcept { return mSize; }
+
+        [[nodiscard]] bool empty() const noexcept { return mSize == 0; }
+
+        [[nodiscard]] address_type startAddress() const noexcept;
+
+        [[nodiscard]] address_type endAddress() const noexcept;
+
+        void clear() noexcept;
+
+        [[nodiscard]] const_iterator begin() const noexcept;
+        [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+        [[nodiscard]] const_iterator end() const noexcept { return const_iterator{ this, const_iterator::npos, 0 }; }
+        [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    private:
+        [[nodiscard]] std::vector<Segment>::const_iterator segmentContaining(address_type address) const noexcept;
+
+        void joinFollowing(std::vector<Segment>::iterator segment);
+
+        std::vector<Segment> mSegments;
+        std::size_t mSize{ 0 };
+    };
+}
@@ -0,0 +1,78 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include <numeric>
+#include "TransferPlan.h"
+
+namespace firmware::reader {
+    TransferPlan fullTransfer(const SparseImage& image) {
+        TransferPlan plan;
+        plan.reserve(image.segments().size());
+        for (const auto& segment : image.segments()) {
+            plan.push_back(TransferRange{ segment.address, segment.data });
+        }
+        return plan;
+    }
+
+    TransferPlan transferRange(const SparseImage& image, SparseImage::address_type begin,
+                               SparseImage::address_type end) {
+        TransferPlan plan;
+        const auto& segments = image.segments();
+        auto segment = std::upper_bound(std::begin(segments), std::end(segments), begin,
+                [](SparseImage::address_type value, const SparseImage::Segment& element) { return value < element.address; });
+        if (segment != std::begin(segments)) {
+            --segment;
+        }
+        for (; segment != std::end(segments) && segment->address < end; ++segment) {
+            const auto first = std::max(begin, segment->address);
+            const auto last = std::min(end, segment->endAddress());
+            if (first < last) {
+                plan.push_back(TransferRange{ first, std::span<const std::byte>{ segment->data }.subspan(
+                        first - segment->address, last - first) });
+            }
+        }
+        return plan;
+    }
+
+    void appendRange(TransferPlan& plan, const TransferRange& range) {
+        if (range.data.empty()) {
+            return;
+        }
+        if (!plan.empty()) {
+            auto& last = plan.back();
+            if (last.address + last.data.size() == range.address && last.data.data() + last.data.size() == range.data.data()) {
+                last.data = std::span<const std::byte>{ last.data.data(), last.data.size() + range.data.size() };
+                return;
+            }
+        }
+        plan.push_back(range);
+    }
+
+    TransferPlan elideBlankBlocks(const TransferPlan& plan, std::size_t blockSize, std::byte blank) {
+        if (blockSize == 0) {
+            return plan;
+        }
+        TransferPlan elided;
+        for (const auto& range : plan) {
+            auto address = range.address;
+            auto data = range.data;
+            while (!data.empty()) {
+                const auto blockEnd = (address / blockSize + 1) * blockSize;
+                const auto block = data.first(std::min<std::size_t>(blockEnd - address, data.size()));
+                if (std::any_of(std::begin(block), std::end(block), [blank](std::byte value) { return value != blank; })) {
+                    appendRange(elided, TransferRange{ address, block });
+                }
+                address += block.size();
+                data = data.subspan(block.size());
+            }
+        }
+        return elided;
+    }
+
+    std::size_t transferSize(const TransferPlan& plan) noexcept {
+        return std::accumulate(std::begin(plan), std::end(plan), std::size_t{ 0 },
+                [](std::size_t sum, const TransferRange& range) { return sum + range.data.size(); });
+    }
+}
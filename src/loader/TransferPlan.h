@@ -0,0 +1,47 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <span>
+#include <vector>
+#include "SparseImage.h"
+
+namespace firmware::reader {
+    /**
+     * A contiguous run of image bytes which is sent as one segment. The data
+     * points into the image the plan was made for.
+     */
+    struct TransferRange {
+        SparseImage::address_type address;
+        std::span<const std::byte> data;
+    };
+
+    using TransferPlan = std::vector<TransferRange>;
+
+    /**
+     * Every byte of the image, one range per segment.
+     */
+    [[nodiscard]] TransferPlan fullTransfer(const SparseImage& image);
+
+    /**
+     * The bytes of the image inside [begin, end), split at segment gaps.
+     */
+    [[nodiscard]] TransferPlan transferRange(const SparseImage& image, SparseImage::address_type begin,
+                                             SparseImage::address_type end);
+
+    /**
+     * Appends a range, merging it with the last one if they are adjacent.
+     */
+    void appendRange(TransferPlan& plan, const TransferRange& range);
+
+    /**
+     * Drops every block of the plan which only holds the blank byte, erased
+     * flash already reads back as blank. Blocks are aligned to multiples of
+     * blockSize, partially blank blocks are kept whole.
+     */
+    [[nodiscard]] TransferPlan elideBlankBlocks(const TransferPlan& plan, std::size_t blockSize, std::byte blank);
+
+    [[nodiscard]] std::size_t transferSize(const TransferPlan& plan) noexcept;
+}
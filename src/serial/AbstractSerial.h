@@ -10,6 +10,8 @@
 #include <memory>
 #include <optional>
 #include <vector>
+#include <span>
+#include <chrono>
 #include <type_traits>
 #include <asio.hpp>
 #include "../utils/SerialUtils.h"
@@ -20,12 +22,24 @@ public:
 
     virtual void writeData(std::byte data) = 0;
 
-    virtual void writeData(const std::vector<std::byte>& data) = 0;
+    virtual void writeData(std::span<const std::byte> data) = 0;
+
+    /**
+     * Blocks until everything written so far has left the UART. Returns
+     * false if the implementation can't tell, callers then have to estimate
+     * the transmission time themselves.
+     */
+    virtual bool drain() { return false; }
 
     virtual std::optional<std::string> reciveByte() = 0;
 
     virtual std::vector<std::byte> reciveBytes() = 0;
 
+    /**
+     * Waits at most the given time for a single byte.
+     */
+    virtual std::optional<std::byte> reciveByteFor(std::chrono::milliseconds timeout) = 0;
+
     [[nodiscard]] virtual bool isOpen() const = 0;
 
     [[nodiscard]] virtual std::optional<std::string> errorMessage() const = 0;
@@ -50,10 +50,19 @@ public:
 #else
     template<typename U = int, typename = std::enable_if_t<mode == SerialMode::TXOnly || mode == SerialMode::Duplex, int>>
 #endif
-    void writeData(const std::vector<std::byte>& data) {
+    void writeData(std::span<const std::byte> data) {
         pimpl->writeData(data);
     }
 
+#ifdef __cpp_concepts
+    template<SerialMode pMode = mode> requires mode == SerialMode::TXOnly || mode == SerialMode::Duplex
+#else
+    template<typename U = int, typename = std::enable_if_t<mode == SerialMode::TXOnly || mode == SerialMode::Duplex, int>>
+#endif
+    bool drain() {
+        return pimpl->drain();
+    }
+
 #ifdef __cpp_concepts
     template<SerialMode pMode = mode> requires mode == SerialMode::RXOnly || mode == SerialMode::Duplex
 #else
@@ -71,6 +80,15 @@ public:
     std::vector<std::byte> reciveBytes() {
         return pimpl->reciveBytes();
     }
+
+#ifdef __cpp_concepts
+    template<SerialMode pMode = mode> requires mode == SerialMode::RXOnly || mode == SerialMode::Duplex
+#else
+    template<typename U = int, typename = std::enable_if_t<mode == SerialMode::RXOnly || mode == SerialMode::Duplex, int>>
+#endif
+    std::optional<std::byte> reciveByteFor(std::chrono::milliseconds timeout) {
+        return pimpl->reciveByteFor(timeout);
+    }
 private:
     const std::unique_ptr<AbstractSerial> pimpl;
 };
@@ -4,6 +4,11 @@
 
 #include "SerialImpl.h"
 
+#ifndef _WIN32
+#include <cerrno>
+#include <termios.h>
+#endif
+
 SerialImpl::SerialImpl(const std::string& device, unsigned int baudrate, serial::utils::SerialConfiguration config) :
     mDevice{ device }, mBaudrate{ baudrate }, mPort{ mIOService } {
 	try {
@@ -44,13 +49,28 @@ void SerialImpl::writeData(std::byte data) {
 	}
 }
 
-void SerialImpl::writeData(const std::vector<std::byte>& data) {
+void SerialImpl::writeData(std::span<const std::byte> data) {
 	if (mOpen) {
-		asio::write(mPort, asio::buffer(data, data.size()));
+		asio::write(mPort, asio::buffer(data.data(), data.size()));
 		mIOService.poll();
 	}
 }
 
+bool SerialImpl::drain() {
+	if (!mOpen) {
+		return false;
+	}
+#ifdef _WIN32
+	return FlushFileBuffers(mPort.native_handle()) != 0;
+#else
+	int result;
+	do {
+		result = ::tcdrain(mPort.native_handle());
+	} while (result != 0 && errno == EINTR);
+	return result == 0;
+#endif
+}
+
 std::optional<std::string> SerialImpl::reciveByte() {
 	if (mOpen) {
 		mIOService.poll();
@@ -69,6 +89,32 @@ std::vector<std::byte> SerialImpl::reciveBytes() {
 	return {};
 }
 
+std::optional<std::byte> SerialImpl::reciveByteFor(std::chrono::milliseconds timeout) {
+	if (!mOpen) {
+		return std::nullopt;
+	}
+	std::byte value{};
+	std::optional<std::byte> result;
+	asio::steady_timer timer{ mIOService, timeout };
+
+	// whichever finishes first cancels the other one
+	asio::async_read(mPort, asio::buffer(&value, 1), [&](const auto& error, std::size_t length) {
+		if (!error && length == 1) {
+			result = value;
+		}
+		timer.cancel();
+	});
+	timer.async_wait([&](const auto& error) {
+		if (!error) {
+			mPort.cancel();
+		}
+	});
+
+	mIOService.restart();
+	mIOService.run();
+	return result;
+}
+
 bool SerialImpl::isOpen() const
 {
 	return mOpen;
@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <vector>
+#include <span>
 #include <type_traits>
 #include <asio.hpp>
 #include "../utils/SerialUtils.h"
@@ -26,12 +27,16 @@ public:
 
     void writeData(std::byte data) override;
 
-    void writeData(const std::vector<std::byte>& data) override;
+    void writeData(std::span<const std::byte> data) override;
+
+    bool drain() override;
 
 	std::optional<std::string> reciveByte() override;
 
 	std::vector<std::byte> reciveBytes() override;
 
+	std::optional<std::byte> reciveByteFor(std::chrono::milliseconds timeout) override;
+
 	[[nodiscard]] bool isOpen() const override;
 
 	[[nodiscard]] std::optional<std::string> errorMessage() const override;
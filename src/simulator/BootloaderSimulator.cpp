@@ -0,0 +1,274 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+#include "BootloaderSimulator.h"
+
+namespace firmware::simulator {
+    namespace {
+        constexpr std::size_t defaultPageSize = 128;
+
+        std::chrono::nanoseconds characterTimeOf(const ::serial::utils::SerialConfiguration& mode, unsigned int baudrate) {
+            const bool parity = mode.parityBit == ::serial::utils::Parity::odd || mode.parityBit == ::serial::utils::Parity::even;
+            // start bit, data bits, parity and stop bits
+            const double bits = 1.0 + mode.dataBits + (parity ? 1.0 : 0.0) + mode.stopBits;
+            return std::chrono::nanoseconds{ static_cast<long>(bits * 1e9 / std::max(baudrate, 1U)) };
+        }
+    }
+
+    BootloaderSimulator::BootloaderSimulator(const json::config::ResolvedDeviceConfig& config, unsigned int baudrate, TimingModel timing)
+        : mConfig{ config }, mTiming{ timing },
+          mPageSize{ timing.pageSize > 0 ? timing.pageSize : config.deviceFlashPageSize > 0 ? config.deviceFlashPageSize : defaultPageSize },
+          mCharacterTime{ characterTimeOf(config.serialMode, baudrate) } {
+        reset();
+    }
+
+    void BootloaderSimulator::receive(std::span<const std::byte> data, clock::time_point time) {
+        for (const auto value : data) {
+            const auto arrival = std::max(mLineFreeAt, time) + mCharacterTime;
+            mLineFreeAt = arrival;
+            advance(arrival);
+            const auto position = mReport.bytesReceived++;
+            if (mFifo.size() >= mTiming.fifoDepth) {
+                mReport.overruns++;
+                if (!mReport.firstOverrun) {
+                    mReport.firstOverrun = position;
+                }
+                continue;
+            }
+            mFifo.push_back(Queued{ arrival, value });
+        }
+    }
+
+    void BootloaderSimulator::advance(clock::time_point time) {
+        while (!mFifo.empty()) {
+            const auto next = mFifo.front();
+            const auto processed = std::max(mReadyAt, next.time);
+            if (processed > time) {
+                return;
+            }
+            mFifo.pop_front();
+            mReport.maxLatency = std::max(mReport.maxLatency, std::chrono::duration_cast<std::chrono::microseconds>(processed - next.time));
+            process(next.data, processed);
+        }
+    }
+
+    std::vector<BootloaderSimulator::Response> BootloaderSimulator::takeResponses() {
+        return std::exchange(mResponses, {});
+    }
+
+    SimulationReport BootloaderSimulator::finish() {
+        advance(clock::time_point::max());
+        return mReport;
+    }
+
+    void BootloaderSimulator::reset() {
+        mFlash.assign(static_cast<std::size_t>(mConfig.deviceFlashAvailable.count()), mConfig.unusedFlashByte);
+        mFifo.clear();
+        mResponses.clear();
+        mLineFreeAt = {};
+        mReadyAt = {};
+        mReport = SimulationReport{};
+        mState = State::Start;
+        mPending = State::Metadata;
+        mBurstRemaining = 0;
+        mMetadata.clear();
+        mValues.clear();
+        mAddress = 0;
+        mRemaining = 0;
+        mOpenPage = std::nullopt;
+        mLiterals = 0;
+        mRun = 0;
+    }
+
+    bool BootloaderSimulator::done() const noexcept {
+        return mState == State::Done || mState == State::Failed;
+    }
+
+    const std::vector<std::byte>& BootloaderSimulator::flash() const noexcept {
+        return mFlash;
+    }
+
+    std::chrono::nanoseconds BootloaderSimulator::characterTime() const noexcept {
+        return mCharacterTime;
+    }
+
+    BootloaderSimulator::clock::time_point BootloaderSimulator::lineIdleAt() const noexcept {
+        return mLineFreeAt;
+    }
+
+    void BootloaderSimulator::process(std::byte data, clock::time_point time) {
+        switch (mState) {
+        case State::Start:
+            // the initial sync only repeats the sync byte, resyncs end with the preamble
+            if (data == mConfig.serialSyncByte) {
+                return;
+            }
+            if (mConfig.serialResyncAfterBurst) {
+                if (data != mConfig.serialPreamble) {
+                    fail("Expected the preamble after the sync bytes");
+                    return;
+                }
+                enter(State::Metadata);
+                return;
+            }
+            enter(State::Metadata);
+            process(data, time);
+            return;
+        case State::Sync:
+            if (data == mConfig.serialSyncByte) {
+                return;
+            }
+            if (data != mConfig.serialPreamble) {
+                fail("Expected the preamble after the sync bytes");
+                return;
+            }
+            enter(mPending);
+            return;
+        case State::Metadata:
+            mMetadata.push_back(data);
+            if (--mBurstRemaining == 0) {
+                // numeric values are sent least significant byte first
+                std::size_t value = 0;
+                for (auto byte = mMetadata.rbegin(); byte != mMetadata.rend(); ++byte) {
+                    value = (value << 8) | std::to_integer<std::size_t>(*byte);
+                }
+                mMetadata.clear();
+                mValues.push_back(value);
+                finishBurst(time, afterMetadata());
+            }
+            return;
+        case State::Data:
+            // bytes behind the announced length only pad the burst
+            if (mRemaining > 0) {
+                if (mConfig.binaryCompression == ::serial::utils::CompressionModes::PackBits) {
+                    decode(data, time);
+                } else {
+                    store(data, time);
+                }
+                if (mRemaining == 0) {
+                    programPage(time);
+                }
+            }
+            if (mState == State::Data && --mBurstRemaining == 0) {
+                if (mRemaining > 0) {
+                    finishBurst(time, State::Data);
+                } else {
+                    finishBurst(time, mConfig.binaryTransfer == ::serial::utils::TransferModes::Segmented ? State::Metadata : State::Done);
+                }
+            }
+            return;
+        case State::Done:
+            fail("Received data after the end of the transfer");
+            return;
+        case State::Failed:
+            return;
+        }
+    }
+
+    void BootloaderSimulator::beginBurst(State next) {
+        if (next == State::Done) {
+            mReport.complete = true;
+            mState = State::Done;
+            return;
+        }
+        if (mConfig.serialResyncAfterBurst) {
+            mPending = next;
+            mState = State::Sync;
+            return;
+        }
+        enter(next);
+    }
+
+    void BootloaderSimulator::enter(State state) {
+        mState = state;
+        mBurstRemaining = state == State::Metadata ? mConfig.serialMetadataSize : mConfig.serialBytesPerBurst;
+    }
+
+    void BootloaderSimulator::finishBurst(clock::time_point time, State next) {
+        if (mConfig.serialAckByte) {
+            // the bootloader answers once it is able to take the next burst
+            mResponses.push_back(Response{ std::max(time, mReadyAt), *mConfig.serialAckByte });
+        }
+        beginBurst(next);
+    }
+
+    BootloaderSimulator::State BootloaderSimulator::afterMetadata() {
+        if (mValues.size() < 2) {
+            return State::Metadata;
+        }
+        mAddress = mValues[0];
+        mRemaining = mValues[1];
+        // the size of a linear transfer is the end address of the image
+        if (mConfig.binaryTransfer == ::serial::utils::TransferModes::Linear) {
+            mRemaining = mValues[1] > mValues[0] ? mValues[1] - mValues[0] : 0;
+        }
+        mValues.clear();
+        mLiterals = 0;
+        mRun = 0;
+        if (mRemaining > 0) {
+            return State::Data;
+        }
+        // an empty segment terminates a segmented transfer
+        if (mConfig.binaryTransfer == ::serial::utils::TransferModes::Segmented && mAddress != 0) {
+            return State::Metadata;
+        }
+        return State::Done;
+    }
+
+    void BootloaderSimulator::decode(std::byte data, clock::time_point time) {
+        if (mLiterals > 0) {
+            mLiterals--;
+            store(data, time);
+        } else if (mRun > 0) {
+            if (mRun > mRemaining) {
+                fail("Run exceeds the announced length");
+                return;
+            }
+            for (; mRun > 0 && mState != State::Failed; --mRun) {
+                store(data, time);
+            }
+        } else {
+            const auto header = std::to_integer<std::size_t>(data);
+            if (header < 128) {
+                mLiterals = header + 1;
+            } else if (header > 128) {
+                mRun = 257 - header;
+            }
+        }
+    }
+
+    void BootloaderSimulator::store(std::byte data, clock::time_point time) {
+        if (mAddress >= mFlash.size()) {
+            fail("Write behind the end of the flash at " + std::to_string(mAddress));
+            return;
+        }
+        const auto page = mAddress / mPageSize;
+        if (mOpenPage && *mOpenPage != page) {
+            programPage(time);
+        }
+        mOpenPage = page;
+        mFlash[mAddress++] = data;
+        mRemaining--;
+        if (mAddress % mPageSize == 0) {
+            programPage(time);
+        }
+    }
+
+    void BootloaderSimulator::programPage(clock::time_point time) {
+        if (!mOpenPage) {
+            return;
+        }
+        mOpenPage = std::nullopt;
+        mReport.pagesWritten++;
+        mReadyAt = std::max(mReadyAt, time) + mTiming.pageWriteTime;
+    }
+
+    void BootloaderSimulator::fail(const std::string& message) {
+        if (!mReport.protocolError) {
+            mReport.protocolError = message;
+        }
+        mState = State::Failed;
+    }
+}
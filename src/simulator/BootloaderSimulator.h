@@ -0,0 +1,173 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "../json/ConfigManager.h"
+
+namespace firmware::simulator {
+    /**
+     * Timing of the simulated device. The defaults roughly match an AVR
+     * bootloader with a small ring buffer behind the UART.
+     */
+    struct TimingModel {
+        // erase and program one page, the bootloader doesn't read the UART meanwhile
+        std::chrono::microseconds pageWriteTime{ 4500 };
+        // bytes the device can hold while it is busy, one more is an overrun
+        std::size_t fifoDepth{ 64 };
+        // 0 takes the page size of the device config, or 128 if it has none
+        std::size_t pageSize{ 0 };
+    };
+
+    struct SimulationReport {
+        std::size_t bytesReceived{ 0 };
+        std::size_t pagesWritten{ 0 };
+        std::size_t overruns{ 0 };
+        // position of the first lost byte in the received stream
+        std::optional<std::size_t> firstOverrun{ std::nullopt };
+        // the longest time a byte waited in the FIFO
+        std::chrono::microseconds maxLatency{ 0 };
+        bool complete{ false };
+        std::optional<std::string> protocolError{ std::nullopt };
+
+        /**
+         * A transfer is safe if it completed without losing a byte.
+         */
+        explicit operator bool() const noexcept {
+            return complete && overruns == 0 && !protocolError;
+        }
+    };
+
+    /**
+     * Stand-in for the bootloader on the device. It parses the stream that
+     * DataSendManager produces (sync bytes, preamble, metadata and data
+     * bursts, linear or segmented, optionally PackBits encoded) and models
+     * the time the device needs: bytes arrive at the speed of the line, a
+     * full page blocks the device for the page write time and bytes that
+     * arrive while the FIFO is full are lost.
+     *
+     * Without resyncs the first byte which isn't a sync byte starts the
+     * transfer, like on the device a start address whose low byte equals
+     * the sync byte can't be told apart from the sync.
+     */
+    class BootloaderSimulator {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        struct Response {
+            clock::time_point time;
+            std::byte data;
+        };
+
+        BootloaderSimulator(const json::config::ResolvedDeviceConfig& config, unsigned int baudrate, TimingModel timing = {});
+
+        /**
+         * Data which was handed to the line at the given time. The bytes
+         * arrive one after another at the speed of the line.
+         */
+        void receive(std::span<const std::byte> data, clock::time_point time);
+
+        /**
+         * Processes every byte the device would have read by the given time.
+         */
+        void advance(clock::time_point time);
+
+        /**
+         * Acknowledgements sent by the device, the time is when they leave it.
+         * Only bytes processed by advance() or receive() have been answered.
+         */
+        [[nodiscard]] std::vector<Response> takeResponses();
+
+        /**
+         * Processes everything still queued and returns the report of the
+         * current or last transfer.
+         */
+        SimulationReport finish();
+
+        /**
+         * Starts over with erased flash, e.g. for the next set of parameters.
+         */
+        void reset();
+
+        /**
+         * True once the transfer completed or failed, everything received
+         * afterwards is ignored until reset().
+         */
+        [[nodiscard]] bool done() const noexcept;
+
+        [[nodiscard]] const std::vector<std::byte>& flash() const noexcept;
+
+        [[nodiscard]] std::chrono::nanoseconds characterTime() const noexcept;
+
+        /**
+         * Time at which the last received byte has completely arrived.
+         */
+        [[nodiscard]] clock::time_point lineIdleAt() const noexcept;
+
+    private:
+        enum class State {
+            Start,
+            Sync,
+            Metadata,
+            Data,
+            Done,
+            Failed
+        };
+
+        struct Queued {
+            clock::time_point time;
+            std::byte data;
+        };
+
+        void process(std::byte data, clock::time_point time);
+
+        void beginBurst(State next);
+
+        void enter(State state);
+
+        void finishBurst(clock::time_point time, State next);
+
+        [[nodiscard]] State afterMetadata();
+
+        void decode(std::byte data, clock::time_point time);
+
+        void store(std::byte data, clock::time_point time);
+
+        void programPage(clock::time_point time);
+
+        void fail(const std::string& message);
+
+        const json::config::ResolvedDeviceConfig mConfig;
+        const TimingModel mTiming;
+        const std::size_t mPageSize;
+        const std::chrono::nanoseconds mCharacterTime;
+
+        std::vector<std::byte> mFlash;
+        std::deque<Queued> mFifo;
+        std::vector<Response> mResponses;
+        clock::time_point mLineFreeAt{};
+        clock::time_point mReadyAt{};
+        SimulationReport mReport;
+
+        State mState{ State::Start };
+        // burst which follows the sync frame
+        State mPending{ State::Metadata };
+        std::size_t mBurstRemaining{ 0 };
+        std::vector<std::byte> mMetadata;
+        std::vector<std::size_t> mValues;
+        std::size_t mAddress{ 0 };
+        std::size_t mRemaining{ 0 };
+        std::optional<std::size_t> mOpenPage{ std::nullopt };
+        // PackBits decoder state: literal bytes still to copy, or length of the pending run
+        std::size_t mLiterals{ 0 };
+        std::size_t mRun{ 0 };
+    };
+}
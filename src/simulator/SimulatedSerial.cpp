@@ -0,0 +1,66 @@
+//
+// Created on 16.10.26.
+//
+
+#include <thread>
+#include "SimulatedSerial.h"
+
+namespace firmware::simulator {
+    SimulatedSerial::SimulatedSerial(std::shared_ptr<BootloaderSimulator> simulator, unsigned int baudrate)
+        : mSimulator{ std::move(simulator) }, mBaudrate{ baudrate } {}
+
+    void SimulatedSerial::writeData(std::byte data) {
+        writeData(std::span<const std::byte>{ &data, 1 });
+    }
+
+    void SimulatedSerial::writeData(std::span<const std::byte> data) {
+        // like a UART with a small transmit buffer, writing blocks while the line is busy
+        std::this_thread::sleep_until(mSimulator->lineIdleAt());
+        mSimulator->receive(data, BootloaderSimulator::clock::now());
+    }
+
+    bool SimulatedSerial::drain() {
+        std::this_thread::sleep_until(mSimulator->lineIdleAt());
+        return true;
+    }
+
+    std::optional<std::string> SimulatedSerial::reciveByte() {
+        auto value = reciveByteFor(std::chrono::milliseconds{ 1000 });
+        if (!value) {
+            return std::nullopt;
+        }
+        return std::string(1, static_cast<char>(*value));
+    }
+
+    std::vector<std::byte> SimulatedSerial::reciveBytes() {
+        return {};
+    }
+
+    std::optional<std::byte> SimulatedSerial::reciveByteFor(std::chrono::milliseconds timeout) {
+        const auto deadline = BootloaderSimulator::clock::now() + timeout;
+        mSimulator->advance(deadline);
+        for (const auto& response : mSimulator->takeResponses()) {
+            mResponses.push_back(response);
+        }
+        if (mResponses.empty() || mResponses.front().time > deadline) {
+            std::this_thread::sleep_until(deadline);
+            return std::nullopt;
+        }
+        const auto response = mResponses.front();
+        mResponses.pop_front();
+        std::this_thread::sleep_until(response.time);
+        return response.data;
+    }
+
+    bool SimulatedSerial::isOpen() const {
+        return true;
+    }
+
+    std::optional<std::string> SimulatedSerial::errorMessage() const {
+        return std::nullopt;
+    }
+
+    unsigned int SimulatedSerial::baudrate() const noexcept {
+        return mBaudrate;
+    }
+}
@@ -0,0 +1,45 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include "../serial/AbstractSerial.h"
+#include "BootloaderSimulator.h"
+
+namespace firmware::simulator {
+    /**
+     * Serial port connected straight to a simulated bootloader. Written data
+     * reaches the simulator with the current time, drain() and received
+     * acknowledgements take as long as the simulated line and device need.
+     */
+    class SimulatedSerial : public AbstractSerial {
+    public:
+        SimulatedSerial(std::shared_ptr<BootloaderSimulator> simulator, unsigned int baudrate);
+
+        void writeData(std::byte data) override;
+
+        void writeData(std::span<const std::byte> data) override;
+
+        bool drain() override;
+
+        std::optional<std::string> reciveByte() override;
+
+        std::vector<std::byte> reciveBytes() override;
+
+        std::optional<std::byte> reciveByteFor(std::chrono::milliseconds timeout) override;
+
+        [[nodiscard]] bool isOpen() const override;
+
+        [[nodiscard]] std::optional<std::string> errorMessage() const override;
+
+        [[nodiscard]] unsigned int baudrate() const noexcept override;
+
+    private:
+        std::shared_ptr<BootloaderSimulator> mSimulator;
+        const unsigned int mBaudrate;
+        std::deque<BootloaderSimulator::Response> mResponses;
+    };
+}
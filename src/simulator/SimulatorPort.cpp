@@ -0,0 +1,114 @@
+//
+// Created on 16.10.26.
+//
+
+#include "SimulatorPort.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace firmware::simulator {
+    SimulatorPort::SimulatorPort(BootloaderSimulator& simulator) : mSimulator{ simulator } {
+        mMaster = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (mMaster < 0 || ::grantpt(mMaster) != 0 || ::unlockpt(mMaster) != 0) {
+            mErrorMessage = std::string{ "Unable to create a pseudo terminal: " } + std::strerror(errno);
+            return;
+        }
+        mDevicePath = ::ptsname(mMaster);
+        // an open slave keeps the master usable while the loader reopens the port
+        mSlave = ::open(mDevicePath.c_str(), O_RDWR | O_NOCTTY);
+        if (mSlave < 0) {
+            mErrorMessage = "Unable to open " + mDevicePath + ": " + std::strerror(errno);
+            return;
+        }
+        termios settings{};
+        ::tcgetattr(mSlave, &settings);
+        ::cfmakeraw(&settings);
+        ::tcsetattr(mSlave, TCSANOW, &settings);
+    }
+
+    SimulatorPort::~SimulatorPort() {
+        if (mSlave >= 0) {
+            ::close(mSlave);
+        }
+        if (mMaster >= 0) {
+            ::close(mMaster);
+        }
+    }
+
+    const std::string& SimulatorPort::devicePath() const noexcept {
+        return mDevicePath;
+    }
+
+    const std::optional<std::string>& SimulatorPort::errorMessage() const noexcept {
+        return mErrorMessage;
+    }
+
+    SimulatorPort::operator bool() const noexcept {
+        return !mErrorMessage;
+    }
+
+    void SimulatorPort::run(const FinishedCallback& finished) {
+        using clock = BootloaderSimulator::clock;
+        std::array<std::byte, 4096> buffer{};
+        std::deque<BootloaderSimulator::Response> responses;
+        std::optional<clock::time_point> lastData;
+
+        const auto finishTransfer = [&]() {
+            finished(mSimulator.finish());
+            mSimulator.reset();
+            responses.clear();
+            lastData.reset();
+        };
+
+        mRunning = true;
+        while (mRunning && *this) {
+            auto wait = std::chrono::milliseconds{ 20 };
+            if (!responses.empty()) {
+                const auto untilResponse = std::chrono::ceil<std::chrono::milliseconds>(responses.front().time - clock::now());
+                wait = std::clamp(untilResponse, std::chrono::milliseconds{ 0 }, wait);
+            }
+            pollfd descriptor{ mMaster, POLLIN, 0 };
+            if (::poll(&descriptor, 1, static_cast<int>(wait.count())) > 0 && (descriptor.revents & POLLIN) != 0) {
+                const auto length = ::read(mMaster, buffer.data(), buffer.size());
+                if (length > 0) {
+                    lastData = clock::now();
+                    mSimulator.receive(std::span{ buffer }.first(static_cast<std::size_t>(length)), *lastData);
+                }
+            }
+
+            const auto now = clock::now();
+            mSimulator.advance(now);
+            for (const auto& response : mSimulator.takeResponses()) {
+                responses.push_back(response);
+            }
+            while (!responses.empty() && responses.front().time <= now) {
+                const auto value = responses.front().data;
+                responses.pop_front();
+                [[maybe_unused]] const auto written = ::write(mMaster, &value, 1);
+            }
+
+            if (mSimulator.done() && responses.empty()) {
+                finishTransfer();
+            } else if (lastData && now - *lastData > idleTimeout) {
+                finishTransfer();
+            }
+        }
+    }
+
+    void SimulatorPort::stop() noexcept {
+        mRunning = false;
+    }
+}
+
+#endif
@@ -0,0 +1,61 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#ifdef __linux__
+
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <string>
+#include "BootloaderSimulator.h"
+
+namespace firmware::simulator {
+    /**
+     * Serves a simulated bootloader on a pseudo terminal, the loader flashes
+     * it through the slave end like a real serial port.
+     */
+    class SimulatorPort {
+    public:
+        using FinishedCallback = std::function<void(const SimulationReport&)>;
+
+        explicit SimulatorPort(BootloaderSimulator& simulator);
+
+        ~SimulatorPort();
+
+        SimulatorPort(const SimulatorPort&) = delete;
+
+        SimulatorPort& operator=(const SimulatorPort&) = delete;
+
+        [[nodiscard]] const std::string& devicePath() const noexcept;
+
+        [[nodiscard]] const std::optional<std::string>& errorMessage() const noexcept;
+
+        explicit operator bool() const noexcept;
+
+        /**
+         * Feeds everything written to the port into the simulator and sends
+         * its acknowledgements back until stop() is called. Every finished,
+         * failed or abandoned transfer is reported and the simulator starts
+         * over for the next one.
+         */
+        void run(const FinishedCallback& finished);
+
+        void stop() noexcept;
+
+        // a started transfer without new data for this long is abandoned
+        static constexpr std::chrono::seconds idleTimeout{ 2 };
+
+    private:
+        BootloaderSimulator& mSimulator;
+        int mMaster{ -1 };
+        int mSlave{ -1 };
+        std::string mDevicePath;
+        std::optional<std::string> mErrorMessage{ std::nullopt };
+        std::atomic<bool> mRunning{ false };
+    };
+}
+
+#endif
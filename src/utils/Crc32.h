@@ -0,0 +1,38 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace utils {
+    namespace detail {
+        constexpr std::array<std::uint32_t, 256> crc32Table = []() {
+            std::array<std::uint32_t, 256> table{};
+            for (std::uint32_t i = 0; i < table.size(); i++) {
+                std::uint32_t value = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+                }
+                table[i] = value;
+            }
+            return table;
+        }();
+    }
+
+    /**
+     * CRC-32 (IEEE 802.3). Pass the result of a previous call as crc to
+     * continue a checksum over several blocks.
+     */
+    [[nodiscard]] constexpr std::uint32_t crc32(std::span<const std::byte> data, std::uint32_t crc = 0) noexcept {
+        crc = ~crc;
+        for (const auto value : data) {
+            crc = detail::crc32Table[(crc ^ std::to_integer<std::uint32_t>(value)) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+}
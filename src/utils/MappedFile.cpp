@@ -0,0 +1,132 @@
+//
+// Created on 15.10.26.
+//
+
+#include <fstream>
+#include <sstream>
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+    MappedFile::MappedFile(const std::filesystem::path& path) noexcept {
+        if (!map(path) && !readBuffered(path)) {
+            std::stringstream ss;
+            ss << "Failed to open: " << path.string();
+            mErrorMessage = ss.str();
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    std::string_view MappedFile::view() const noexcept {
+        if (mMapped) {
+            return { mData, mSize };
+        }
+        return mBuffer;
+    }
+
+    bool MappedFile::isMapped() const noexcept {
+        return mMapped;
+    }
+
+    const std::optional<std::string>& MappedFile::errorMessage() const noexcept {
+        return mErrorMessage;
+    }
+
+    MappedFile::operator bool() const noexcept {
+        return !mErrorMessage;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::map(const std::filesystem::path& path) noexcept {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+        // the view keeps the mapping alive, so both handles can be closed now
+        auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr) {
+            return false;
+        }
+        mData = static_cast<const char*>(view);
+        mSize = static_cast<std::size_t>(size.QuadPart);
+        mMapped = true;
+        return true;
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (mMapped) {
+            UnmapViewOfFile(mData);
+            mMapped = false;
+        }
+    }
+#else
+    bool MappedFile::map(const std::filesystem::path& path) noexcept {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat fileInfo{};
+        // empty files and non regular files (pipes, devices) can't be mapped
+        if (::fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode) || fileInfo.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        const auto size = static_cast<std::size_t>(fileInfo.st_size);
+        void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        ::madvise(view, size, MADV_SEQUENTIAL);
+        mData = static_cast<const char*>(view);
+        mSize = size;
+        mMapped = true;
+        return true;
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (mMapped) {
+            ::munmap(const_cast<char*>(mData), mSize);
+            mMapped = false;
+        }
+    }
+#endif
+
+    bool MappedFile::readBuffered(const std::filesystem::path& path) noexcept {
+        try {
+            std::ifstream file{ path, std::ios::in | std::ios::binary };
+            if (!file.good()) {
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            mBuffer = buffer.str();
+            return true;
+        } catch (std::exception&) {
+            return false;
+        }
+    }
+}
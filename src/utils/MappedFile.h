@@ -0,0 +1,48 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace utils {
+    /**
+     * Read-only view of a whole file. The file is memory mapped where the
+     * platform allows it, otherwise it is read into an internal buffer.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& path) noexcept;
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] std::string_view view() const noexcept;
+
+        [[nodiscard]] bool isMapped() const noexcept;
+
+        [[nodiscard]] const std::optional<std::string>& errorMessage() const noexcept;
+
+        explicit operator bool() const noexcept;
+
+    private:
+        bool map(const std::filesystem::path& path) noexcept;
+
+        void unmap() noexcept;
+
+        bool readBuffered(const std::filesystem::path& path) noexcept;
+
+        const char* mData{ nullptr };
+        std::size_t mSize{ 0 };
+        bool mMapped{ false };
+        std::string mBuffer;
+        std::optional<std::string> mErrorMessage{ std::nullopt };
+    };
+}
@@ -0,0 +1,74 @@
+//
+// Created on 15.10.26.
+//
+
+#include <algorithm>
+#include "PackBits.h"
+
+namespace utils {
+    namespace {
+        constexpr std::size_t maxPacketLength = 128;
+        // shorter runs are cheaper inside a literal packet
+        constexpr std::size_t minRunLength = 3;
+
+        std::size_t runLength(std::span<const std::byte> data) noexcept {
+            const auto limit = std::min(data.size(), maxPacketLength);
+            std::size_t length = 1;
+            while (length < limit && data[length] == data[0]) {
+                ++length;
+            }
+            return length;
+        }
+    }
+
+    void packBits(std::span<const std::byte> data, std::vector<std::byte>& encoded) {
+        std::size_t literalStart = 0;
+        std::size_t position = 0;
+        const auto flushLiterals = [&]() {
+            while (literalStart < position) {
+                const auto length = std::min(position - literalStart, maxPacketLength);
+                encoded.push_back(std::byte(length - 1));
+                const auto literals = data.subspan(literalStart, length);
+                encoded.insert(std::end(encoded), std::begin(literals), std::end(literals));
+                literalStart += length;
+            }
+        };
+
+        while (position < data.size()) {
+            const auto length = runLength(data.subspan(position));
+            if (length < minRunLength) {
+                position += length;
+                continue;
+            }
+            flushLiterals();
+            encoded.push_back(std::byte(257 - length));
+            encoded.push_back(data[position]);
+            position += length;
+            literalStart = position;
+        }
+        flushLiterals();
+    }
+
+    utils::expected<std::vector<std::byte>, std::string> unpackBits(std::span<const std::byte> encoded) {
+        std::vector<std::byte> decoded;
+        while (!encoded.empty()) {
+            const auto header = std::to_integer<std::size_t>(encoded[0]);
+            encoded = encoded.subspan(1);
+            if (header < 128) {
+                if (encoded.size() < header + 1) {
+                    return utils::make_unexpected("Literal packet exceeds the encoded data");
+                }
+                const auto literals = encoded.first(header + 1);
+                decoded.insert(std::end(decoded), std::begin(literals), std::end(literals));
+                encoded = encoded.subspan(header + 1);
+            } else if (header > 128) {
+                if (encoded.empty()) {
+                    return utils::make_unexpected("Run packet without a value");
+                }
+                decoded.insert(std::end(decoded), 257 - header, encoded[0]);
+                encoded = encoded.subspan(1);
+            }
+        }
+        return decoded;
+    }
+}
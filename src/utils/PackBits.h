@@ -0,0 +1,23 @@
+//
+// Created on 15.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+#include "expected.h"
+
+namespace utils {
+    /**
+     * PackBits run length encoding. A header byte n in [0, 127] is followed
+     * by n + 1 literal bytes, a header in [129, 255] repeats the next byte
+     * 257 - n times, 128 is skipped. Encoded blocks can be concatenated, the
+     * decoder needs no state beyond the current packet.
+     */
+    void packBits(std::span<const std::byte> data, std::vector<std::byte>& encoded);
+
+    [[nodiscard]] utils::expected<std::vector<std::byte>, std::string> unpackBits(std::span<const std::byte> encoded);
+}
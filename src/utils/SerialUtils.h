@@ -23,9 +23,27 @@ namespace serial::utils {
 
     enum class BinaryFormats {
         IntelHex,
+        RawBinary,
+        SRecord,
         Unknown
     };
-}
- 
 
+    /**
+     * Linear: start address and size, followed by every byte up to the end.
+     * Segmented: address and length before every segment, a zero length
+     * segment terminates the transfer.
+     */
+    enum class TransferModes {
+        Linear,
+        Segmented
+    };
 
+    /**
+     * Encoding of the image bytes inside the transfer, the address and size
+     * metadata always count uncompressed bytes.
+     */
+    enum class CompressionModes {
+        None,
+        PackBits
+    };
+}
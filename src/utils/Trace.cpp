@@ -0,0 +1,144 @@
+//
+// Created on 16.10.26.
+//
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include "Trace.h"
+
+namespace utils::trace {
+    namespace {
+        struct Recorder {
+            std::atomic<bool> enabled{ false };
+            std::mutex mutex;
+            clock::time_point origin{ clock::now() };
+            std::vector<Event> events;
+            std::atomic<std::size_t> threads{ 0 };
+        };
+
+        Recorder& recorder() {
+            static Recorder instance;
+            return instance;
+        }
+
+        std::size_t threadNumber() {
+            thread_local const std::size_t number = ++recorder().threads;
+            return number;
+        }
+
+        void writeString(std::ostream& stream, std::string_view text) {
+            stream << '"';
+            for (const char c : text) {
+                if (c == '"' || c == '\\') {
+                    stream << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                           << std::dec << std::setfill(' ');
+                } else {
+                    stream << c;
+                }
+            }
+            stream << '"';
+        }
+
+        double microseconds(clock::duration duration) {
+            return std::chrono::duration<double, std::micro>{ duration }.count();
+        }
+    }
+
+    void enable() {
+        auto& instance = recorder();
+        std::lock_guard lock{ instance.mutex };
+        instance.events.clear();
+        instance.origin = clock::now();
+        instance.enabled = true;
+    }
+
+    void disable() noexcept {
+        recorder().enabled = false;
+    }
+
+    bool enabled() noexcept {
+        return recorder().enabled.load(std::memory_order_relaxed);
+    }
+
+    std::vector<Event> events() {
+        auto& instance = recorder();
+        std::lock_guard lock{ instance.mutex };
+        return instance.events;
+    }
+
+    void writeChromeTrace(std::ostream& stream) {
+        const auto recorded = events();
+        stream << R"({"displayTimeUnit":"ms","traceEvents":[)" << '\n'
+               << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"firmware-loader"}})";
+        stream << std::fixed << std::setprecision(3);
+        for (const auto& event : recorded) {
+            stream << ",\n{\"name\":";
+            writeString(stream, event.name);
+            stream << ",\"cat\":";
+            writeString(stream, event.category);
+            stream << R"(,"ph":"X","pid":1,"tid":)" << event.thread
+                   << ",\"ts\":" << microseconds(event.start)
+                   << ",\"dur\":" << microseconds(event.duration);
+            if (event.bytes > 0) {
+                stream << R"(,"args":{"bytes":)" << event.bytes << '}';
+            }
+            stream << '}';
+        }
+        stream << "\n]}\n";
+    }
+
+    bool writeChromeTrace(const std::filesystem::path& file) {
+        std::ofstream stream{ file, std::ios::out | std::ios::trunc };
+        writeChromeTrace(stream);
+        return stream.good();
+    }
+
+    Span::Span(std::string_view name, std::string_view category, std::size_t bytes) noexcept :
+            mName{ name },
+            mCategory{ category },
+            mBytes{ bytes },
+            mActive{ enabled() },
+            mStart{ mActive ? clock::now() : clock::time_point{} } {
+    }
+
+    Span::~Span() {
+        if (!mActive) {
+            return;
+        }
+        const auto end = clock::now();
+        auto& instance = recorder();
+        try {
+            const auto thread = threadNumber();
+            std::lock_guard lock{ instance.mutex };
+            // spans which were still open when the recording restarted belong to no trace
+            if (mStart < instance.origin) {
+                return;
+            }
+            instance.events.push_back(Event{ std::string{ mName }, std::string{ mCategory }, mStart - instance.origin,
+                                             end - mStart, thread, mBytes });
+        } catch (std::exception&) {
+            // a lost span must not end the transfer
+        }
+    }
+
+    Recording::Recording(std::filesystem::path file) : mFile{ std::move(file) } {
+        enable();
+    }
+
+    Recording::~Recording() {
+        disable();
+        try {
+            if (writeChromeTrace(mFile)) {
+                std::cout << "Trace written to " << mFile.string() << std::endl;
+            } else {
+                std::cout << "Unable to write the trace " << mFile.string() << std::endl;
+            }
+        } catch (std::exception&) {
+        }
+    }
+}
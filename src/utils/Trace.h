@@ -0,0 +1,89 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Timing spans of the phases of a transfer, exported in the Chrome
+ * trace_event format (load the file in chrome://tracing or Perfetto).
+ * Recording is off by default, a span then costs a single atomic load.
+ */
+namespace utils::trace {
+    using clock = std::chrono::steady_clock;
+
+    struct Event {
+        std::string name;
+        std::string category;
+        // relative to the start of the recording
+        clock::duration start;
+        clock::duration duration;
+        // small number per thread, in the order the threads recorded their first span
+        std::size_t thread;
+        // payload of the span, 0 if it has none
+        std::size_t bytes;
+    };
+
+    /**
+     * Drops all recorded events and records the following spans.
+     */
+    void enable();
+
+    void disable() noexcept;
+
+    [[nodiscard]] bool enabled() noexcept;
+
+    [[nodiscard]] std::vector<Event> events();
+
+    void writeChromeTrace(std::ostream& stream);
+
+    bool writeChromeTrace(const std::filesystem::path& file);
+
+    /**
+     * Measures the time until it is destroyed. Name and category must
+     * outlive the span, usually they are literals.
+     */
+    class Span {
+    public:
+        Span(std::string_view name, std::string_view category, std::size_t bytes = 0) noexcept;
+
+        ~Span();
+
+        Span(const Span&) = delete;
+
+        Span& operator=(const Span&) = delete;
+
+    private:
+        std::string_view mName;
+        std::string_view mCategory;
+        std::size_t mBytes;
+        bool mActive;
+        clock::time_point mStart;
+    };
+
+    /**
+     * Records while it exists and writes the trace to the file when it is
+     * destroyed.
+     */
+    class Recording {
+    public:
+        explicit Recording(std::filesystem::path file);
+
+        ~Recording();
+
+        Recording(const Recording&) = delete;
+
+        Recording& operator=(const Recording&) = delete;
+
+    private:
+        std::filesystem::path mFile;
+    };
+}
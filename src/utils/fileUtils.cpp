@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <optional>
 #include "fileUtils.h"
 
 namespace utils {
@@ -16,4 +18,47 @@ namespace utils {
             return utils::make_unexpected(ss.str());
         }
     }
+
+    bool matchesGlob(std::string_view name, std::string_view pattern) noexcept {
+        std::size_t n = 0;
+        std::size_t p = 0;
+        // position after the last '*' and the name position it was tried at
+        std::optional<std::pair<std::size_t, std::size_t>> backtrack;
+        while (n < name.size()) {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+                ++n;
+                ++p;
+            } else if (p < pattern.size() && pattern[p] == '*') {
+                backtrack = std::pair{ ++p, n };
+            } else if (backtrack) {
+                p = backtrack->first;
+                n = ++backtrack->second;
+            } else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern[p] == '*') {
+            ++p;
+        }
+        return p == pattern.size();
+    }
+
+    std::vector<std::string> expandGlob(const std::string& pattern) {
+        const std::filesystem::path path{ pattern };
+        const auto namePattern = path.filename().string();
+        if (namePattern.find_first_of("*?") == std::string::npos) {
+            return { pattern };
+        }
+
+        const auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path{ "." };
+        std::vector<std::string> matches;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator{ directory, error }) {
+            if (matchesGlob(entry.path().filename().string(), namePattern)) {
+                matches.push_back((path.has_parent_path() ? entry.path() : entry.path().filename()).string());
+            }
+        }
+        std::sort(std::begin(matches), std::end(matches));
+        return matches;
+    }
 }
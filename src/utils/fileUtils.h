@@ -2,8 +2,23 @@
 #include <filesystem>
 #include <sstream>
 #include <fstream>
+#include <string_view>
+#include <vector>
 #include "expected.h"
 
 namespace utils {
     utils::expected<const std::string, const std::string> readFile(const std::filesystem::path& path) noexcept;
+
+    /**
+     * Shell style match of a file name, '*' matches any run of characters
+     * and '?' a single one.
+     */
+    [[nodiscard]] bool matchesGlob(std::string_view name, std::string_view pattern) noexcept;
+
+    /**
+     * All paths matching a pattern with wildcards in its file name, sorted.
+     * A pattern without wildcards is returned unchanged, even if the path
+     * doesn't exist.
+     */
+    [[nodiscard]] std::vector<std::string> expandGlob(const std::string& pattern);
 }
\ No newline at end of file
@@ -1,4 +1,8 @@
+#pragma once
+
 #include <iostream>
+#include <iomanip>
+#include <string>
 
 namespace utils {
     template<typename T>
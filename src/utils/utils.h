@@ -1,12 +1,15 @@
 #pragma once
 
 #include<type_traits>
+#include <charconv>
 #include <limits>
+#include <optional>
 #include <cmath>
 #include <chrono>
 #include <ratio>
 #include <string_view>
 #include <vector>
+#include <array>
 #include "RatioLookup.h"
 
 namespace utils {
@@ -67,6 +70,24 @@ namespace utils {
         return returnVector;
     }
 
+    /**
+     * Parses a decimal or 0x prefixed hex address. A leading 0 doesn't make
+     * the value octal, so "0800" is 800.
+     */
+    [[nodiscard]] inline std::optional<unsigned long> parseAddress(std::string_view text) noexcept {
+        int base = 10;
+        if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+            text.remove_prefix(2);
+            base = 16;
+        }
+        unsigned long value = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+        if (text.empty() || error != std::errc{} || end != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
     namespace printable {
         template<typename Rep, typename p>
         std::ostream& operator<< (std::ostream& stream, const std::chrono::duration<Rep, p>& duration) {
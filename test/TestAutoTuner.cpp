@@ -0,0 +1,113 @@
+//
+// Created on 16.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include "../src/loader/AutoTuner.h"
+
+namespace test {
+    using firmware::serial::TransferParameters;
+    using namespace std::chrono_literals;
+
+    // a device which loses data with bursts above 64 bytes, delays below 5ms or more than 4 unacknowledged bursts
+    std::optional<std::string> limitedDevice(const TransferParameters& parameters) {
+        if (parameters.bytesPerBurst > 64) {
+            return "burst too large";
+        }
+        if (parameters.acknowledged()) {
+            return parameters.ackWindow > 4 ? std::optional<std::string>{ "window too large" } : std::nullopt;
+        }
+        if (parameters.flashBurstDelay < 5ms) {
+            return "delay too short";
+        }
+        return std::nullopt;
+    }
+
+    TEST_CASE("The auto tuner finds the fastest passing parameters", "[AutoTuner]") {
+        const firmware::serial::AutoTuner tuner{ TransferParameters{ 16, 20ms } };
+        const auto result = tuner.tune(limitedDevice);
+
+        REQUIRE(result.verified);
+        REQUIRE(result.parameters == TransferParameters{ 64, 5ms });
+        REQUIRE(result.trials.size() <= firmware::serial::TuningLimits{}.maxTrials);
+        REQUIRE(result.trials.front().parameters == TransferParameters{ 16, 20ms });
+        REQUIRE_FALSE(result.trials.back().error);
+        REQUIRE(result.trials.back().parameters == result.parameters);
+    }
+
+    TEST_CASE("Acknowledged transfers tune the ack window instead of the delay", "[AutoTuner]") {
+        const firmware::serial::AutoTuner tuner{ TransferParameters{ 16, 20ms, 1 } };
+        const auto result = tuner.tune(limitedDevice);
+
+        REQUIRE(result.verified);
+        REQUIRE(result.parameters == TransferParameters{ 64, 20ms, 4 });
+        REQUIRE(result.trials.size() <= firmware::serial::TuningLimits{}.maxTrials);
+        for (const auto& trial : result.trials) {
+            REQUIRE(trial.parameters.flashBurstDelay == 20ms);
+        }
+        REQUIRE_FALSE(result.trials.back().error);
+        REQUIRE(result.trials.back().parameters == result.parameters);
+    }
+
+    TEST_CASE("The closing trials count against the budget", "[AutoTuner]") {
+        firmware::serial::TuningLimits limits;
+        limits.maxTrials = 5;
+        const firmware::serial::AutoTuner tuner{ TransferParameters{ 64, 20ms }, limits };
+        const auto result = tuner.tune(limitedDevice);
+
+        REQUIRE(result.verified);
+        REQUIRE(result.trials.size() <= limits.maxTrials);
+        REQUIRE(result.trials.back().error == std::nullopt);
+        REQUIRE(result.trials.back().parameters == result.parameters);
+    }
+
+    TEST_CASE("The auto tuner keeps to its limits", "[AutoTuner]") {
+        firmware::serial::TuningLimits limits;
+        limits.maxBytesPerBurst = 32;
+        limits.minFlashBurstDelay = 8ms;
+        limits.maxTrials = 5;
+        const firmware::serial::AutoTuner tuner{ TransferParameters{ 16, 20ms }, limits };
+        const auto result = tuner.tune(limitedDevice);
+
+        REQUIRE(result.verified);
+        REQUIRE(result.trials.size() <= limits.maxTrials);
+        REQUIRE(result.parameters.bytesPerBurst == 32);
+        REQUIRE(result.parameters.flashBurstDelay >= 8ms);
+        for (const auto& trial : result.trials) {
+            REQUIRE(trial.parameters.bytesPerBurst <= 32);
+            REQUIRE(trial.parameters.flashBurstDelay >= 8ms);
+        }
+    }
+
+    TEST_CASE("The auto tuner stops if the start parameters fail", "[AutoTuner]") {
+        const firmware::serial::AutoTuner tuner{ TransferParameters{ 128, 20ms } };
+        const auto result = tuner.tune(limitedDevice);
+
+        REQUIRE_FALSE(result.verified);
+        REQUIRE(result.trials.size() == 1);
+        REQUIRE(result.parameters == TransferParameters{ 128, 20ms });
+    }
+
+    TEST_CASE("Tuned parameters are stored per device and port", "[AutoTuner]") {
+        const auto folder = std::filesystem::temp_directory_path() / "FiremwareLoaderTests/AutoTuner";
+        std::filesystem::remove_all(folder);
+        const auto file = folder / firmware::serial::TuningStore::defaultFile;
+        {
+            firmware::serial::TuningStore store{ file };
+            REQUIRE_FALSE(store.find("atmega328p", "/dev/ttyUSB0"));
+            REQUIRE(store.store("atmega328p", "/dev/ttyUSB0", TransferParameters{ 64, 5ms }));
+            REQUIRE(store.store("atmega328p", "/dev/ttyUSB1", TransferParameters{ 32, 9ms, 4 }));
+            REQUIRE(store.store("atmega328p", "/dev/ttyUSB0", TransferParameters{ 128, 4ms }));
+        }
+
+        const firmware::serial::TuningStore store{ file };
+        REQUIRE(store.find("atmega328p", "/dev/ttyUSB0") == TransferParameters{ 128, 4ms });
+        REQUIRE(store.find("atmega328p", "/dev/ttyUSB1") == TransferParameters{ 32, 9ms, 4 });
+        REQUIRE_FALSE(store.find("atmega2560", "/dev/ttyUSB0"));
+
+        // files of another format are ignored instead of being misread
+        std::ofstream{ file, std::ios::trunc } << "something else\natmega328p\t/dev/ttyUSB0\t64\t5\n";
+        REQUIRE_FALSE(firmware::serial::TuningStore{ file }.find("atmega328p", "/dev/ttyUSB0"));
+    }
+}
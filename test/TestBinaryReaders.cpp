@@ -0,0 +1,103 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include "../src/loader/BinReader.h"
+#include "../src/loader/SRecReader.h"
+#include "../src/loader/ReaderFactory.h"
+#include "../src/utils/utils.h"
+
+namespace test {
+    std::filesystem::path writeFirmwareFile(const std::string& name, const std::string& content) {
+        auto path = std::filesystem::path{ std::filesystem::temp_directory_path() };
+        path /= "fileware_loader_firmware/" + name;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream stream{ path, std::ios::out | std::ios::binary };
+        stream << content;
+        return path;
+    }
+
+    TEST_CASE("Binary Reader base address", "[Binary Reader Test]") {
+        auto path = writeFirmwareFile("firmware.bin", std::string{ "\x01\x02\x00\x04", 4 });
+
+        firmware::reader::BinReader reader{ path.string(), CustomDataTypes::ComputerScience::megabyte{1}, 0x100 };
+        REQUIRE(static_cast<bool>(reader));
+        REQUIRE(reader.getStartAddress() == 0x100);
+        REQUIRE(reader.image().size() == 4);
+        REQUIRE(reader.image().at(0x102) == std::byte{ 0x00 });
+        REQUIRE(reader.image().at(0x103) == std::byte{ 0x04 });
+
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("S-Record Reader", "[S-Record Reader Test]") {
+        auto path = writeFirmwareFile("firmware.s19", "S00700007465737438\r\n"
+                                                      "S107010001020304ED\r\n"
+                                                      "S2060001040506E9\r\n"
+                                                      "S5030002FA\r\n"
+                                                      "S9030100FB\r\n");
+
+        firmware::reader::SRecReader reader{ path.string(), CustomDataTypes::ComputerScience::megabyte{1} };
+        REQUIRE(static_cast<bool>(reader));
+        REQUIRE(reader.getNoErrors() == 0);
+        REQUIRE(reader.getStartAddress() == 0x100);
+        REQUIRE(reader.image().size() == 6);
+        REQUIRE(reader.image().segments().size() == 1);
+        REQUIRE(reader.image().at(0x105) == std::byte{ 0x06 });
+        REQUIRE(reader.executionAddress() == 0x100);
+
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("S-Record Reader errors", "[S-Record Reader Test]") {
+        // broken checksum and a record overwriting data with another value
+        auto path = writeFirmwareFile("firmware.s19", "S107010001020304EE\n"
+                                                      "S107010001020304ED\n"
+                                                      "S104010009F1\n");
+
+        firmware::reader::SRecReader reader{ path.string(), CustomDataTypes::ComputerScience::megabyte{1} };
+        REQUIRE(!static_cast<bool>(reader));
+        REQUIRE(reader.getNoErrors() == 2);
+        REQUIRE(reader.errorMessage().has_value());
+
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("S-Record Reader reports overlapping records", "[S-Record Reader Test]") {
+        // the same record twice, then another value for 0x100
+        auto path = writeFirmwareFile("firmware.s19", "S107010001020304ED\n"
+                                                      "S107010001020304ED\n"
+                                                      "S104010009F1\n");
+
+        firmware::reader::SRecReader reader{ path.string(), CustomDataTypes::ComputerScience::megabyte{1} };
+        REQUIRE(!static_cast<bool>(reader));
+        REQUIRE(reader.getNoWarnings() == 4);
+        REQUIRE(reader.warnings().front() == "Location 0x100 already contains data 0x1 @ line 2");
+        REQUIRE(reader.getNoErrors() == 1);
+        REQUIRE(reader.errorMessage()->find("Couldn't add 0x9 @ 0x100; already contains 0x1 @ line 3") != std::string::npos);
+
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("Address parsing", "[Utils Test]") {
+        REQUIRE(utils::parseAddress("0800") == 800UL);
+        REQUIRE(utils::parseAddress("0x0800") == 0x800UL);
+        REQUIRE(utils::parseAddress("0XfF") == 0xFFUL);
+        REQUIRE(!utils::parseAddress(""));
+        REQUIRE(!utils::parseAddress("0x"));
+        REQUIRE(!utils::parseAddress("08h"));
+        REQUIRE(!utils::parseAddress("-1"));
+    }
+
+    TEST_CASE("Reader format selection", "[Reader Factory Test]") {
+        using serial::utils::BinaryFormats;
+        REQUIRE(firmware::reader::formatFromFile("firmware.HEX", BinaryFormats::Unknown) == BinaryFormats::IntelHex);
+        REQUIRE(firmware::reader::formatFromFile("firmware.bin", BinaryFormats::IntelHex) == BinaryFormats::RawBinary);
+        REQUIRE(firmware::reader::formatFromFile("firmware.s37", BinaryFormats::IntelHex) == BinaryFormats::SRecord);
+        REQUIRE(firmware::reader::formatFromFile("firmware.img", BinaryFormats::IntelHex) == BinaryFormats::IntelHex);
+        REQUIRE(firmware::reader::makeReader(BinaryFormats::Unknown, "firmware.img",
+                                             CustomDataTypes::ComputerScience::megabyte{1}) == nullptr);
+    }
+}
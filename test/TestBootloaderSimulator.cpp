@@ -0,0 +1,157 @@
+//
+// Created on 16.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <thread>
+#include "../src/simulator/SimulatedSerial.h"
+#include "../src/simulator/SimulatorPort.h"
+#include "../src/loader/DataSendManager.h"
+#include "../src/loader/BinReader.h"
+#include "../src/loader/TransferPlan.h"
+
+namespace test {
+    std::string simulatorJson(const std::string& transfer, const std::string& compression, bool acknowledged, bool resync) {
+        return R"({
+  "device": {
+    "general": { "id": "atmega328p", "vendor": "Microchip", "arch": "AVR", "subarch": "ATMega", "name": "Atmega328p" },
+    "flash": { "total": "32KB", "available": "30KB", "pageSize": 128 },
+    "eeprom": { "total": "1KB", "available": "1023B" }
+  },
+  "serial": {
+    "general": { "mode": "8N1", "bytesPerBurst": 64, "metadataByteSize": 2, "minBaudrate": 9600, "maxBaudrate": 115200 },
+    "write": { "waitTimeForReset": "5ms", "eepromBurstDelay": "0ms", "flashBurstDelay": "0ms" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": ")" + std::string{resync ? "true" : "false"} + '"'
+            + (acknowledged ? R"(, "ackByte": "0x06", "ackWindow": 2, "ackTimeout": "500ms")" : "") + R"( }
+  },
+  "binary": { "format": "Binary", "transfer": ")" + transfer + R"(", "compression": ")" + compression + R"(", "unusedFlashByte": "0xFF" }
+})";
+    }
+
+    struct SimulatorSetup {
+        std::filesystem::path folder;
+        firmware::json::config::ConfigManager config;
+        firmware::reader::BinReader reader;
+    };
+
+    SimulatorSetup simulatorSetup(const std::string& json) {
+        const auto folder = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests/Simulator";
+        std::filesystem::create_directories(folder);
+        std::ofstream{folder / "config.json"} << json;
+        {
+            std::ofstream image{folder / "image.bin", std::ios::binary};
+            for (int i = 0; i < 1000; ++i) {
+                image.put(static_cast<char>(i < 600 ? i * 7 : 0x42));
+            }
+        }
+        using namespace CustomDataTypes::ComputerScience::literals;
+        return SimulatorSetup{folder, firmware::json::config::ConfigManager{folder / "config.json"},
+                              firmware::reader::BinReader{(folder / "image.bin").string(), 30_kB, 0x100}};
+    }
+
+    void requireFlashed(const firmware::simulator::BootloaderSimulator& simulator, const firmware::reader::SparseImage& image) {
+        for (const auto& segment : image.segments()) {
+            const auto flashed = std::span{simulator.flash()}.subspan(segment.address, segment.data.size());
+            REQUIRE(std::equal(std::begin(flashed), std::end(flashed), std::begin(segment.data)));
+        }
+        REQUIRE(simulator.flash().at(0xFF) == std::byte{0xFF});
+    }
+
+    TEST_CASE("Simulated bootloader receives a linear transfer", "[Bootloader Simulator Test]") {
+        auto setup = simulatorSetup(simulatorJson("linear", "none", false, false));
+        const auto& config = *setup.config.resolved();
+        auto simulator = std::make_shared<firmware::simulator::BootloaderSimulator>(config, 115200);
+
+        firmware::serial::DataSendManager manager{setup.config, std::make_unique<firmware::simulator::SimulatedSerial>(simulator, 115200)};
+        setup.reader.writeToStream(manager, [](double) {});
+        manager.flush();
+
+        const auto report = simulator->finish();
+        REQUIRE(static_cast<bool>(report));
+        REQUIRE(report.overruns == 0);
+        REQUIRE(report.pagesWritten == 8);
+        requireFlashed(*simulator, setup.reader.image());
+        std::filesystem::remove_all(setup.folder);
+    }
+
+    TEST_CASE("Simulated bootloader acknowledges compressed segments", "[Bootloader Simulator Test]") {
+        auto setup = simulatorSetup(simulatorJson("segmented", "packbits", true, true));
+        const auto& config = *setup.config.resolved();
+        auto simulator = std::make_shared<firmware::simulator::BootloaderSimulator>(config, 115200);
+
+        firmware::serial::DataSendManager manager{setup.config, std::make_unique<firmware::simulator::SimulatedSerial>(simulator, 115200)};
+        const auto plan = firmware::reader::fullTransfer(setup.reader.image());
+        setup.reader.writeRanges(manager, plan, [](double) {});
+        manager.flush();
+
+        const auto report = simulator->finish();
+        REQUIRE(!report.protocolError);
+        REQUIRE(static_cast<bool>(report));
+        requireFlashed(*simulator, setup.reader.image());
+        std::filesystem::remove_all(setup.folder);
+    }
+
+    TEST_CASE("Simulated bootloader flags overruns", "[Bootloader Simulator Test]") {
+        auto setup = simulatorSetup(simulatorJson("linear", "none", false, false));
+        const auto& config = *setup.config.resolved();
+        firmware::simulator::TimingModel timing;
+        timing.fifoDepth = 8;
+        timing.pageWriteTime = std::chrono::milliseconds{20};
+        firmware::simulator::BootloaderSimulator simulator{config, 115200, timing};
+
+        // everything at once, as if the loader didn't wait between bursts at all
+        std::vector<std::byte> stream{std::byte{0x00}, std::byte{0x01}, std::byte{0x00}, std::byte{0x02}};
+        stream.resize(stream.size() + 256, std::byte{0x42});
+        simulator.receive(stream, firmware::simulator::BootloaderSimulator::clock::now());
+
+        const auto report = simulator.finish();
+        REQUIRE(!static_cast<bool>(report));
+        REQUIRE(report.overruns > 0);
+        REQUIRE(report.firstOverrun == 4 + 128 + 8);
+    }
+
+    TEST_CASE("Simulated bootloader expects the preamble", "[Bootloader Simulator Test]") {
+        auto setup = simulatorSetup(simulatorJson("linear", "none", false, true));
+        firmware::simulator::BootloaderSimulator simulator{*setup.config.resolved(), 115200};
+
+        const std::vector<std::byte> stream{std::byte{0xCC}, std::byte{0xCC}, std::byte{0x12}};
+        simulator.receive(stream, firmware::simulator::BootloaderSimulator::clock::now());
+
+        const auto report = simulator.finish();
+        REQUIRE(report.protocolError.has_value());
+        REQUIRE(simulator.done());
+        simulator.reset();
+        REQUIRE(!simulator.done());
+        std::filesystem::remove_all(setup.folder);
+    }
+
+#ifdef __linux__
+    TEST_CASE("Simulated bootloader behind a pseudo terminal", "[Bootloader Simulator Test]") {
+        auto setup = simulatorSetup(simulatorJson("linear", "none", true, false));
+        firmware::simulator::BootloaderSimulator simulator{*setup.config.resolved(), 115200};
+        firmware::simulator::SimulatorPort port{simulator};
+        REQUIRE(static_cast<bool>(port));
+
+        std::vector<firmware::simulator::SimulationReport> reports;
+        std::thread server{[&]() {
+            port.run([&](const firmware::simulator::SimulationReport& report) {
+                reports.push_back(report);
+                port.stop();
+            });
+        }};
+        {
+            const std::string& device = port.devicePath();
+            firmware::serial::DataSendManager manager{setup.config, {device, 115200}, std::chrono::milliseconds{5}};
+            // every burst waits for the acknowledgement coming back through the pty
+            setup.reader.writeToStream(manager, [](double) {});
+            manager.flush();
+        }
+        server.join();
+
+        REQUIRE(reports.size() == 1);
+        REQUIRE(static_cast<bool>(reports.front()));
+        std::filesystem::remove_all(setup.folder);
+    }
+#endif
+}
@@ -0,0 +1,42 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <vector>
+#include "../src/loader/BurstBuffer.h"
+
+namespace test {
+    TEST_CASE("Burst Buffer keeps bytes in order", "[Burst Buffer Test]") {
+        firmware::serial::BurstBuffer buffer{ 4 };
+        const std::vector<std::byte> data{ std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5} };
+
+        REQUIRE(buffer.append(data) == 4);
+        REQUIRE(buffer.size() == 4);
+
+        auto burst = buffer.front(3);
+        REQUIRE(burst.size() == 3);
+        REQUIRE(burst[0] == std::byte{1});
+        REQUIRE(burst[2] == std::byte{3});
+        buffer.consume(burst.size());
+
+        // the remaining byte is moved to the front to make room
+        REQUIRE(buffer.append(std::span<const std::byte>{ data }.subspan(4)) == 1);
+        REQUIRE(buffer.size() == 2);
+        REQUIRE(buffer.front(2)[0] == std::byte{4});
+        REQUIRE(buffer.front(2)[1] == std::byte{5});
+    }
+
+    TEST_CASE("Burst Buffer padding", "[Burst Buffer Test]") {
+        firmware::serial::BurstBuffer buffer{ 4 };
+        buffer.push_back(std::byte{1});
+        buffer.padTo(3, std::byte{0xFF});
+
+        REQUIRE(buffer.size() == 3);
+        REQUIRE(buffer.front(3)[2] == std::byte{0xFF});
+
+        buffer.consume(3);
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.capacity() == 4);
+    }
+}
@@ -0,0 +1,60 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+#include "../src/loader/BurstPipeline.h"
+
+namespace test {
+    TEST_CASE("Burst Pipeline keeps bursts in order", "[Burst Pipeline Test]") {
+        std::vector<std::byte> sent;
+        firmware::serial::BurstPipeline pipeline{ 2, 2, [&sent](std::span<const std::byte> burst) {
+            sent.insert(std::end(sent), std::begin(burst), std::end(burst));
+        } };
+
+        std::vector<std::byte> data;
+        for (unsigned int i = 0; i < 64; i++) {
+            data.push_back(std::byte(i));
+        }
+        for (std::size_t i = 0; i < data.size(); i += 2) {
+            pipeline.push(std::span<const std::byte>{ data }.subspan(i, 2));
+        }
+        pipeline.wait();
+
+        REQUIRE(sent == data);
+    }
+
+    TEST_CASE("Burst Pipeline reports failed sends", "[Burst Pipeline Test]") {
+        firmware::serial::BurstPipeline pipeline{ 2, 1, [](std::span<const std::byte>) {
+            throw std::runtime_error("port closed");
+        } };
+
+        const std::byte data{ 0 };
+        pipeline.push(std::span<const std::byte>{ &data, 1 });
+        REQUIRE_THROWS_AS(pipeline.wait(), std::runtime_error);
+        REQUIRE_THROWS_AS(pipeline.push(std::span<const std::byte>{ &data, 1 }), std::runtime_error);
+    }
+
+    TEST_CASE("Burst Pipeline can be reset after a failed send", "[Burst Pipeline Test]") {
+        bool fail = true;
+        std::vector<std::byte> sent;
+        firmware::serial::BurstPipeline pipeline{ 2, 1, [&fail, &sent](std::span<const std::byte> burst) {
+            if (fail) {
+                throw std::runtime_error("port closed");
+            }
+            sent.insert(std::end(sent), std::begin(burst), std::end(burst));
+        } };
+
+        const std::byte data{ 7 };
+        pipeline.push(std::span<const std::byte>{ &data, 1 });
+        REQUIRE_THROWS_AS(pipeline.wait(), std::runtime_error);
+
+        pipeline.reset();
+        fail = false;
+        pipeline.push(std::span<const std::byte>{ &data, 1 });
+        pipeline.wait();
+        REQUIRE(sent == std::vector<std::byte>{ data });
+    }
+}
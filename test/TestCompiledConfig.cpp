@@ -0,0 +1,114 @@
+//
+// Created on 16.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include "../src/json/CompiledConfig.h"
+
+namespace test {
+    const std::string compiledJson = R"({
+  "device": {
+    "general": { "id": "atmega328p", "vendor": "Microchip", "arch": "AVR", "subarch": "ATMega", "name": "Atmega328p" },
+    "flash": { "total": "32KB", "available": "30KB", "pageSize": 128 },
+    "eeprom": { "total": "1KB", "available": "1023B" }
+  },
+  "serial": {
+    "general": { "mode": "8N2", "bytesPerBurst": 16, "metadataByteSize": 2, "minBaudrate": 9600, "maxBaudrate": 57600 },
+    "write": { "waitTimeForReset": "1s", "eepromBurstDelay": "100ms", "flashBurstDelay": "9ms" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": "true", "ackByte": "0x06" }
+  },
+  "binary": { "format": "Intel Hex", "transfer": "segmented", "compression": "packbits", "unusedFlashByte": "0xFF" }
+})";
+
+    TEST_CASE("Compiled configs match their JSON", "[Compiled Config Test]") {
+        auto root = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_compile";
+        std::filesystem::remove_all(root);
+        const auto source = root / "config" / "AVR" / "atmega328p.json";
+        std::filesystem::create_directories(source.parent_path());
+        std::ofstream{source} << compiledJson;
+        std::ofstream{root / "config" / "AVR" / "broken.json"} << R"({"device": {}})";
+
+        const auto report = firmware::json::config::compileConfigs(root / "config", root / "compiled");
+        REQUIRE(report.compiled == 1);
+        REQUIRE(report.errors.size() == 1);
+
+        const firmware::json::config::ConfigManager manager{source};
+        const auto& expected = *manager.resolved();
+        const auto compiledPath = firmware::json::config::compiledConfigPath(root / "compiled", "atmega328p");
+        const auto loaded = firmware::json::config::loadCompiledConfig(compiledPath, source);
+        REQUIRE(loaded.has_value());
+        REQUIRE(loaded->deviceID == expected.deviceID);
+        REQUIRE(loaded->deviceName == expected.deviceName);
+        REQUIRE(loaded->deviceFlashAvailable == expected.deviceFlashAvailable);
+        REQUIRE(loaded->deviceFlashPageSize == 128);
+        REQUIRE(loaded->serialMode.dataBits == 8);
+        REQUIRE(loaded->serialMode.parityBit == expected.serialMode.parityBit);
+        REQUIRE(loaded->serialMode.stopBits == expected.serialMode.stopBits);
+        REQUIRE(loaded->serialBytesPerBurst == 16);
+        REQUIRE(loaded->serialWaitTimeForReset == expected.serialWaitTimeForReset);
+        REQUIRE(loaded->serialFlashBurstDelay == expected.serialFlashBurstDelay);
+        REQUIRE(loaded->serialResyncAfterBurst);
+        REQUIRE(loaded->serialAckByte == std::byte{0x06});
+        REQUIRE(loaded->serialAckTimeout == expected.serialAckTimeout);
+        REQUIRE(loaded->binaryTransfer == serial::utils::TransferModes::Segmented);
+        REQUIRE(loaded->binaryCompression == serial::utils::CompressionModes::PackBits);
+        REQUIRE(loaded->unusedFlashByte == std::byte{0xFF});
+        std::filesystem::remove_all(root);
+    }
+
+    TEST_CASE("Options of compiled configs are served by the ConfigManager", "[Compiled Config Test]") {
+        auto root = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_compile";
+        std::filesystem::remove_all(root);
+        const auto source = root / "config" / "AVR" / "atmega328p.json";
+        std::filesystem::create_directories(source.parent_path());
+        std::ofstream{source} << compiledJson;
+        const auto compiledFolder = firmware::json::config::compiledConfigFolder(root / "config");
+        REQUIRE(firmware::json::config::compileConfigs(root / "config", compiledFolder).compiled == 1);
+        REQUIRE(std::filesystem::is_regular_file(firmware::json::config::compiledConfigPath(compiledFolder, "atmega328p")));
+
+        using firmware::json::config::JsonOptions;
+        const firmware::json::config::ConfigManager manager{"atmega328p", root / "config"};
+        REQUIRE(manager);
+        REQUIRE(manager.resolved());
+        REQUIRE(manager.getJSONValue<JsonOptions::deviceName>() == "Atmega328p");
+        REQUIRE(manager.getJSONValue<JsonOptions::serialBytesPerBurst>() == 16);
+        REQUIRE(manager.getJSONValue<JsonOptions::serialAckByte>() == std::byte{0x06});
+        REQUIRE(manager.getOptionalJSONValue<JsonOptions::deviceFlashPageSize>() == std::size_t{128});
+        REQUIRE(manager.getOptionalJSONValue<JsonOptions::binaryTransfer>() == serial::utils::TransferModes::Segmented);
+        std::filesystem::remove_all(root);
+    }
+
+    TEST_CASE("Compiled configs are rejected when outdated or damaged", "[Compiled Config Test]") {
+        auto root = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_compile";
+        std::filesystem::remove_all(root);
+        const auto source = root / "config" / "atmega328p.json";
+        std::filesystem::create_directories(source.parent_path());
+        std::ofstream{source} << compiledJson;
+        REQUIRE(firmware::json::config::compileConfigs(root / "config", root / "compiled").compiled == 1);
+        const auto compiledPath = firmware::json::config::compiledConfigPath(root / "compiled", "atmega328p");
+
+        {
+            std::ofstream stream{source, std::ios::app};
+            stream << "\n";
+        }
+        REQUIRE(!firmware::json::config::loadCompiledConfig(compiledPath, source).has_value());
+
+        REQUIRE(firmware::json::config::compileConfigs(root / "config", root / "compiled").compiled == 1);
+        REQUIRE(firmware::json::config::loadCompiledConfig(compiledPath, source).has_value());
+        std::filesystem::resize_file(compiledPath, std::filesystem::file_size(compiledPath) - 1);
+        REQUIRE(!firmware::json::config::loadCompiledConfig(compiledPath, source).has_value());
+
+        // an enum value behind the last enumerator, the compression is stored right before the unused flash byte
+        REQUIRE(firmware::json::config::compileConfigs(root / "config", root / "compiled").compiled == 1);
+        {
+            std::fstream stream{compiledPath, std::ios::in | std::ios::out | std::ios::binary};
+            stream.seekp(static_cast<std::streamoff>(std::filesystem::file_size(compiledPath) - 5));
+            stream.put(static_cast<char>(7));
+        }
+        const auto outOfRange = firmware::json::config::loadCompiledConfig(compiledPath, source);
+        REQUIRE(!outOfRange.has_value());
+        REQUIRE(outOfRange.error().find("Compiled config is damaged") != std::string::npos);
+        std::filesystem::remove_all(root);
+    }
+}
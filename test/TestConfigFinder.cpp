@@ -141,4 +141,27 @@ namespace test {
         REQUIRE(contents->empty());
         std::filesystem::remove_all(path);
     }
-}
\ No newline at end of file
+
+    TEST_CASE("config behind sibling folders", "[ConfigFinder test]") {
+        auto path = std::filesystem::path{ std::filesystem::temp_directory_path() };
+        path /= "fileware_loader_config";
+
+        for (const auto* folder : {"a", "b", "c", "d", "e"}) {
+            std::filesystem::create_directories(path / "devices" / folder / "nested");
+        }
+        auto configPath = path / "devices" / "c" / "mcu3.json";
+        {
+            std::ofstream stream{configPath};
+            stream << "Test String";
+        }
+
+        ConfigFinder finder{"mcu3", path};
+        REQUIRE(static_cast<bool>(finder.getFileLocation()));
+        REQUIRE(*finder.getFileLocation() == configPath);
+
+        auto found = finder.findFile("mcu3.json", path.string());
+        REQUIRE(static_cast<bool>(found));
+        REQUIRE(*found == configPath);
+        std::filesystem::remove_all(path);
+    }
+}
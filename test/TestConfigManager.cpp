@@ -94,6 +94,20 @@ namespace test {
             REQUIRE(manager.getJSONValue<firmware::json::config::JsonOptions::binaryFormat>() == serial::utils::BinaryFormats::IntelHex);
             REQUIRE(manager.getJSONValue<firmware::json::config::JsonOptions::unusedFlashByte>() == std::byte{0xFF});
         }
+
+        SECTION("Resolved values") {
+            REQUIRE(static_cast<bool>(manager.resolved()));
+            const auto& config = *manager.resolved();
+            REQUIRE(config.deviceID == "atmega328p");
+            REQUIRE(config.deviceFlashAvailable == 30_kB);
+            REQUIRE(config.serialMode.dataBits == 8);
+            REQUIRE(config.serialBytesPerBurst == 16);
+            REQUIRE(config.serialFlashBurstDelay == 9ms);
+            REQUIRE(config.serialSyncByte == std::byte{0xCC});
+            REQUIRE(config.serialResyncAfterBurst);
+            REQUIRE(config.binaryFormat == serial::utils::BinaryFormats::IntelHex);
+            REQUIRE(config.unusedFlashByte == std::byte{0xFF});
+        }
     }
 
     TEST_CASE("Test Nonexistent File", "[Nonexistent file Test]") {
@@ -127,5 +141,6 @@ namespace test {
 #ifdef __cpp_exceptions
         REQUIRE_THROWS_AS(manager.getJSONValue<firmware::json::config::JsonOptions::deviceID>(), std::runtime_error);
 #endif
+        REQUIRE(!static_cast<bool>(manager.resolved()));
     }
 }
\ No newline at end of file
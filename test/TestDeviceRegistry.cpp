@@ -0,0 +1,82 @@
+//
+// Created on 16.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <thread>
+#include "../src/json/DeviceRegistry.h"
+
+namespace test {
+    TEST_CASE("Device registry indexes every config", "[Device Registry Test]") {
+        auto root = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_registry";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root / "AVR" / "ATMega");
+        std::filesystem::create_directories(root / "ARM" / "Cortex");
+        std::filesystem::create_directories(root / "Empty");
+        {
+            std::ofstream stream{root / "AVR" / "ATMega" / "atmega328p.json"};
+            stream << R"({"device": {"general": {"id": "atmega328p", "vendor": "Microchip", "arch": "AVR"}}})";
+        }
+        std::ofstream{root / "ARM" / "Cortex" / "stm32f104.json"} << "not json";
+        std::ofstream{root / "ARM" / "readme.txt"} << "no config";
+
+        const firmware::json::config::DeviceRegistry registry{root};
+        REQUIRE(registry.devices().size() == 2);
+        const auto atmega = registry.find("atmega328p");
+        REQUIRE(atmega);
+        REQUIRE(atmega->path == root / "AVR" / "ATMega" / "atmega328p.json");
+        REQUIRE(atmega->vendor == "Microchip");
+        REQUIRE(atmega->arch == "AVR");
+        REQUIRE(registry.find("stm32f104"));
+        REQUIRE(!registry.find("readme"));
+        std::filesystem::remove_all(root);
+    }
+
+    TEST_CASE("Device registry cache follows directory changes", "[Device Registry Test]") {
+        auto root = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_registry";
+        const auto cacheFile = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_registry.index";
+        std::filesystem::remove_all(root);
+        std::filesystem::remove(cacheFile);
+        std::filesystem::create_directories(root / "AVR");
+        std::ofstream{root / "AVR" / "mcu1.json"} << "{}";
+
+        REQUIRE(!firmware::json::config::DeviceRegistry{root, cacheFile}.loadedFromCache());
+        const firmware::json::config::DeviceRegistry cached{root, cacheFile};
+        REQUIRE(cached.loadedFromCache());
+        REQUIRE(cached.find("mcu1"));
+
+        // directory times can be coarse, make sure the new file changes it
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::ofstream{root / "AVR" / "mcu2.json"} << "{}";
+        std::filesystem::last_write_time(root / "AVR", std::filesystem::file_time_type::clock::now() + std::chrono::seconds(1));
+
+        const firmware::json::config::DeviceRegistry rescanned{root, cacheFile};
+        REQUIRE(!rescanned.loadedFromCache());
+        REQUIRE(rescanned.find("mcu2"));
+
+        std::filesystem::remove_all(root);
+        std::filesystem::remove(cacheFile);
+    }
+
+    TEST_CASE("Device registry notices changes and rescans in place", "[Device Registry Test]") {
+        auto root = std::filesystem::path{std::filesystem::temp_directory_path()} / "fileware_loader_registry";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root / "AVR");
+        std::ofstream{root / "AVR" / "mcu1.json"} << "{}";
+
+        firmware::json::config::DeviceRegistry registry{root};
+        REQUIRE(registry.upToDate());
+        REQUIRE(!registry.find("mcu2"));
+
+        std::ofstream{root / "AVR" / "mcu2.json"} << "{}";
+        std::filesystem::last_write_time(root / "AVR", std::filesystem::file_time_type::clock::now() + std::chrono::seconds(1));
+        REQUIRE(!registry.upToDate());
+
+        registry.rescan();
+        REQUIRE(registry.upToDate());
+        REQUIRE(registry.find("mcu1"));
+        REQUIRE(registry.find("mcu2"));
+        std::filesystem::remove_all(root);
+    }
+}
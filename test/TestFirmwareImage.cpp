@@ -0,0 +1,38 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include "../src/loader/FirmwareImage.h"
+#include "../src/loader/BinReader.h"
+
+namespace test {
+    TEST_CASE("Frozen image shares the reader image", "[Firmware Image Test]") {
+        auto binaryPath = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests/frozen.bin";
+        std::filesystem::create_directories(binaryPath.parent_path());
+        {
+            std::ofstream stream{binaryPath, std::ios::binary};
+            stream << "firmware";
+        }
+
+        auto reader = std::make_unique<firmware::reader::BinReader>(binaryPath.string(), CustomDataTypes::ComputerScience::byte{1024}, 0x20);
+        const auto* loaded = &reader->image();
+        const auto image = firmware::reader::FirmwareImage::freeze(std::move(reader));
+
+        REQUIRE(image);
+        REQUIRE(*image);
+        REQUIRE(&image->image() == loaded);
+        REQUIRE(image->getStartAddress() == 0x20);
+        REQUIRE(image->getFileSize() == CustomDataTypes::ComputerScience::byte{0x28});
+        std::filesystem::remove(binaryPath);
+    }
+
+    TEST_CASE("Frozen image keeps reader errors", "[Firmware Image Test]") {
+        auto image = firmware::reader::FirmwareImage::freeze(std::make_unique<firmware::reader::BinReader>(
+                "/this/file/does/not/exist.bin", CustomDataTypes::ComputerScience::byte{1024}));
+        REQUIRE(image);
+        REQUIRE(!*image);
+        REQUIRE(image->errorMessage().has_value());
+        REQUIRE(firmware::reader::FirmwareImage::freeze(nullptr) == nullptr);
+    }
+}
@@ -0,0 +1,186 @@
+//
+// Created on 16.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <thread>
+#include <asio.hpp>
+#include "testClasses/SerialTestImpl.h"
+#include "../src/daemon/FlashDaemon.h"
+
+namespace test {
+    const std::string daemonJson = R"({
+  "device": {
+    "general": { "id": "atmega328p", "vendor": "Microchip", "arch": "AVR", "subarch": "ATMega", "name": "Atmega328p" },
+    "flash": { "total": "32KB", "available": "30KB" },
+    "eeprom": { "total": "1KB", "available": "1023B" }
+  },
+  "serial": {
+    "general": { "mode": "8N1", "bytesPerBurst": 2, "metadataByteSize": 2, "minBaudrate": 9600, "maxBaudrate": 57600 },
+    "write": { "waitTimeForReset": "5ms", "eepromBurstDelay": "100ms", "flashBurstDelay": "1ms" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": "false" }
+  },
+  "binary": { "format": "Intel Hex", "unusedFlashByte": "0xFF" }
+})";
+
+    struct DaemonFiles {
+        std::filesystem::path directory{std::filesystem::temp_directory_path() / "FiremwareLoaderTests/daemon"};
+        std::filesystem::path config{directory / "config.json"};
+        std::filesystem::path binary{directory / "app.bin"};
+
+        DaemonFiles() {
+            std::filesystem::create_directories(directory);
+            std::ofstream{config} << daemonJson;
+            std::ofstream{binary, std::ios::binary} << "abc";
+        }
+
+        ~DaemonFiles() {
+            std::filesystem::remove_all(directory);
+        }
+
+        [[nodiscard]] std::string job(const std::string& port) const {
+            return R"({"config": ")" + config.string() + R"(", "port": ")" + port + R"(", "file": ")" + binary.string() + R"("})";
+        }
+    };
+
+    firmware::daemon::FlashDaemon::ConnectFunction testConnect(int& connects) {
+        return [&connects](const firmware::json::config::ConfigManager& manager, const std::string&, unsigned int) {
+            connects++;
+            return std::make_unique<firmware::serial::DataSendManager>(manager, std::make_unique<SerialTestImpl>(
+                    "/dev/null", 9600, serial::utils::SerialConfiguration{8, serial::utils::Parity::none, 1}), false);
+        };
+    }
+
+    TEST_CASE("Daemon job parsing", "[Daemon Test]") {
+        auto job = firmware::daemon::FlashDaemon::parseJob(
+                R"({"device": "atmega328p", "port": "/dev/ttyUSB0", "file": "/tmp/app.hex", "baud": 57600, "baseAddress": "0x100"})");
+        REQUIRE(job.has_value());
+        REQUIRE(job->device == "atmega328p");
+        REQUIRE(job->port == "/dev/ttyUSB0");
+        REQUIRE(job->baudrate == 57600);
+        REQUIRE(job->baseAddress == 0x100);
+        REQUIRE(!job->manifestDirectory);
+
+        REQUIRE(!firmware::daemon::FlashDaemon::parseJob(R"({"device": "atmega328p", "file": "app.hex"})").has_value());
+        REQUIRE(!firmware::daemon::FlashDaemon::parseJob("not json").has_value());
+        // the daemon doesn't know the working directory of the client
+        REQUIRE(!firmware::daemon::FlashDaemon::parseJob(R"({"device": "atmega328p", "port": "/dev/ttyUSB0", "file": "app.hex"})").has_value());
+        REQUIRE(!firmware::daemon::FlashDaemon::parseJob(
+                R"({"config": "config.json", "port": "/dev/ttyUSB0", "file": "/tmp/app.hex"})").has_value());
+    }
+
+    TEST_CASE("Daemon keeps configs, images and ports", "[Daemon Test]") {
+        DaemonFiles files;
+        int connects = 0;
+        firmware::daemon::FlashDaemon daemon{files.directory / "daemon.sock", testConnect(connects)};
+
+        for (int i = 0; i < 2; i++) {
+            std::vector<std::string> replies;
+            daemon.execute(files.job("ttyTest0"), [&replies](const std::string& line) { replies.push_back(line); });
+            REQUIRE(!replies.empty());
+            REQUIRE(replies.back().rfind("ok 3 ", 0) == 0);
+        }
+        REQUIRE(connects == 1);
+        REQUIRE(daemon.cachedConfigs() == 1);
+        REQUIRE(daemon.cachedImages() == 1);
+        REQUIRE(daemon.openPorts() == 1);
+
+        std::string error;
+        daemon.execute(R"({"config": "/does/not/exist.json", "port": "ttyTest0", "file": "app.bin"})",
+                       [&error](const std::string& line) { error = line; });
+        REQUIRE(error.rfind("error ", 0) == 0);
+    }
+
+    TEST_CASE("Daemon reloads a changed config", "[Daemon Test]") {
+        DaemonFiles files;
+        int connects = 0;
+        firmware::daemon::FlashDaemon daemon{files.directory / "daemon.sock", testConnect(connects)};
+        std::string last;
+        const auto reply = [&last](const std::string& line) { last = line; };
+
+        daemon.execute(files.job("ttyTest0"), reply);
+        REQUIRE(last.rfind("ok 3 ", 0) == 0);
+        std::ofstream{files.config, std::ios::trunc} << daemonJson;
+        std::filesystem::last_write_time(files.config, std::filesystem::last_write_time(files.config) + std::chrono::seconds{2});
+        daemon.execute(files.job("ttyTest0"), reply);
+        REQUIRE(last.rfind("ok 3 ", 0) == 0);
+
+        // the port was opened again with the new config
+        REQUIRE(connects == 2);
+        REQUIRE(daemon.cachedConfigs() == 1);
+        REQUIRE(daemon.openPorts() == 1);
+    }
+
+#ifdef ASIO_HAS_LOCAL_SOCKETS
+    TEST_CASE("Daemon serves jobs on a local socket", "[Daemon Test]") {
+        DaemonFiles files;
+        int connects = 0;
+        const auto socketPath = files.directory / "daemon.sock";
+        firmware::daemon::FlashDaemon daemon{socketPath, testConnect(connects)};
+        std::thread server{[&daemon]() { daemon.run(); }};
+
+        asio::io_service service;
+        asio::local::stream_protocol::socket socket{service};
+        asio::error_code error;
+        for (int attempt = 0; attempt < 100; attempt++) {
+            socket.connect(asio::local::stream_protocol::endpoint{socketPath.string()}, error);
+            if (!error) {
+                break;
+            }
+            socket.close();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(!error);
+        asio::write(socket, asio::buffer(files.job("ttyTest0") + "\n"));
+
+        asio::streambuf buffer;
+        asio::read(socket, buffer, error);
+        std::istream stream{&buffer};
+        std::string line;
+        std::string last;
+        while (std::getline(stream, line)) {
+            last = line;
+        }
+        REQUIRE(last.rfind("ok 3 ", 0) == 0);
+
+        daemon.stop();
+        server.join();
+        REQUIRE(!std::filesystem::exists(socketPath));
+    }
+
+    TEST_CASE("Daemon closes connections without a request", "[Daemon Test]") {
+        DaemonFiles files;
+        int connects = 0;
+        const auto socketPath = files.directory / "daemon.sock";
+        firmware::daemon::FlashDaemon daemon{socketPath, testConnect(connects),
+                                             firmware::daemon::FlashDaemon::defaultCachedImages, std::chrono::milliseconds{50}};
+        std::thread server{[&daemon]() { daemon.run(); }};
+
+        asio::io_service service;
+        asio::local::stream_protocol::socket socket{service};
+        asio::error_code error;
+        for (int attempt = 0; attempt < 100; attempt++) {
+            socket.connect(asio::local::stream_protocol::endpoint{socketPath.string()}, error);
+            if (!error) {
+                break;
+            }
+            socket.close();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(!error);
+        REQUIRE((std::filesystem::status(socketPath).permissions() & std::filesystem::perms::all) ==
+                (std::filesystem::perms::owner_read | std::filesystem::perms::owner_write));
+
+        // the client never sends a line, the daemon hangs up on it
+        asio::write(socket, asio::buffer(std::string{"{"}));
+        asio::streambuf buffer;
+        asio::read(socket, buffer, error);
+        REQUIRE(error == asio::error::eof);
+        REQUIRE(buffer.size() == 0);
+
+        daemon.stop();
+        server.join();
+        REQUIRE(connects == 0);
+    }
+#endif
+}
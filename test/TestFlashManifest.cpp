@@ -0,0 +1,64 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <string_view>
+#include "../src/loader/FlashManifest.h"
+#include "../src/utils/Crc32.h"
+
+namespace test {
+    firmware::reader::SparseImage manifestImage() {
+        firmware::reader::SparseImage image;
+        for (unsigned long address = 0; address < 64; address++) {
+            image.insert(address, std::byte(address));
+        }
+        image.insert(0x100, std::byte{0xAA});
+        return image;
+    }
+
+    TEST_CASE("CRC-32 check value", "[Flash Manifest Test]") {
+        constexpr std::string_view check{ "123456789" };
+        REQUIRE(utils::crc32(std::as_bytes(std::span{ check.data(), check.size() })) == 0xCBF43926u);
+    }
+
+    TEST_CASE("Flash Manifest finds changed pages", "[Flash Manifest Test]") {
+        const auto image = manifestImage();
+        const firmware::reader::FlashManifest manifest{ image, 16 };
+        REQUIRE(manifest.pages().size() == 5);
+        REQUIRE(manifest.changedPages(image).empty());
+
+        auto changed = manifestImage();
+        changed.clear();
+        for (unsigned long address = 0; address < 64; address++) {
+            changed.insert(address, std::byte(address == 20 ? 0xFF : address));
+        }
+        changed.insert(0x101, std::byte{0xAA});
+
+        const auto plan = manifest.changedPages(changed);
+        REQUIRE(plan.size() == 2);
+        REQUIRE(plan[0].address == 16);
+        REQUIRE(plan[0].data.size() == 16);
+        REQUIRE(plan[1].address == 0x101);
+        REQUIRE(firmware::reader::transferSize(plan) == 17);
+    }
+
+    TEST_CASE("Flash Manifest round trip", "[Flash Manifest Test]") {
+        auto directory = std::filesystem::path{ std::filesystem::temp_directory_path() } / "fileware_loader_manifest";
+        std::filesystem::remove_all(directory);
+        const auto path = firmware::reader::FlashManifest::location(directory, "atmega328p", "/dev/ttyUSB0");
+        REQUIRE(path.filename() == "atmega328p__dev_ttyUSB0.manifest");
+
+        const auto image = manifestImage();
+        REQUIRE(!firmware::reader::FlashManifest::load(path).has_value());
+        REQUIRE(firmware::reader::FlashManifest{ image, 16 }.store(path));
+
+        const auto loaded = firmware::reader::FlashManifest::load(path);
+        REQUIRE(loaded.has_value());
+        REQUIRE(loaded->pageSize() == 16);
+        REQUIRE(loaded->pages() == firmware::reader::FlashManifest{ image, 16 }.pages());
+        REQUIRE(loaded->changedPages(image).empty());
+
+        std::filesystem::remove_all(directory);
+    }
+}
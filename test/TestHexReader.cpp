@@ -67,4 +67,13 @@ namespace test {
 
         std::filesystem::remove_all(path);
     }
-}
\ No newline at end of file
+
+    TEST_CASE("Hex Reader Test missing file", "[Filesize Test]") {
+        auto path = std::filesystem::path{ std::filesystem::temp_directory_path() };
+        path /= "fileware_loader_firmware/missing.hex";
+
+        firmware::reader::HexReader reader{path.string(), CustomDataTypes::ComputerScience::megabyte{10}};
+        REQUIRE(!static_cast<bool>(reader));
+        REQUIRE(reader.errorMessage().has_value());
+    }
+}
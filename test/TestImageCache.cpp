@@ -0,0 +1,83 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include "../src/loader/ImageCache.h"
+#include "../src/loader/HexReader.h"
+
+namespace test {
+    std::filesystem::path cacheDirectory() {
+        auto path = std::filesystem::path{ std::filesystem::temp_directory_path() };
+        path /= "fileware_loader_cache";
+        std::filesystem::remove_all(path);
+        return path;
+    }
+
+    using firmware::reader::ImageCache;
+
+    TEST_CASE("Image Cache round trip", "[Image Cache Test]") {
+        firmware::reader::ImageCache cache{ cacheDirectory() };
+        const auto source = ImageCache::sourceKey("source");
+        firmware::reader::SparseImage image;
+        image.insert(0x10, std::byte{ 0x01 });
+        image.insert(0x11, std::byte{ 0x02 });
+        image.insert(0x40, std::byte{ 0x03 });
+
+        REQUIRE(!cache.load(source).has_value());
+        REQUIRE(cache.store(source, image));
+
+        auto cached = cache.load(source);
+        REQUIRE(cached.has_value());
+        REQUIRE(cached->size() == 3);
+        REQUIRE(cached->segments().size() == 2);
+        REQUIRE(cached->at(0x40) == std::byte{ 0x03 });
+
+        REQUIRE(!cache.load(ImageCache::sourceKey("changed source")).has_value());
+
+        // an entry under the name of another source of the same size is not taken for it
+        const auto other = ImageCache::sourceKey("sourcf");
+        std::filesystem::copy_file(cache.entryPath(source), cache.entryPath(other));
+        REQUIRE(!cache.load(other).has_value());
+    }
+
+    TEST_CASE("Image Cache rejects damaged entries", "[Image Cache Test]") {
+        firmware::reader::ImageCache cache{ cacheDirectory() };
+        const auto source = ImageCache::sourceKey("source");
+        firmware::reader::SparseImage image;
+        image.insert(0x00, std::byte{ 0x01 });
+        REQUIRE(cache.store(source, image));
+
+        const auto entry = cache.entryPath(source);
+        std::filesystem::resize_file(entry, std::filesystem::file_size(entry) - 1);
+        REQUIRE(!cache.load(source).has_value());
+    }
+
+    TEST_CASE("Hex Reader uses the Image Cache", "[Image Cache Test]") {
+        const std::string content(":100000000C9434000C943E000C943E000C943E0082\n"
+                                  ":0200A000FFCF90\n"
+                                  ":00000001FF");
+        auto path = std::filesystem::path{ std::filesystem::temp_directory_path() };
+        path /= "fileware_loader_firmware/cached.hex";
+        std::filesystem::create_directories(path.parent_path());
+        {
+            std::ofstream stream{ path };
+            stream << content;
+        }
+
+        firmware::reader::ImageCache cache{ cacheDirectory() };
+        firmware::reader::HexReader parsed{ path.string(), CustomDataTypes::ComputerScience::megabyte{1}, &cache };
+        REQUIRE(static_cast<bool>(parsed));
+        REQUIRE(std::filesystem::exists(cache.entryPath(ImageCache::sourceKey(content))));
+
+        firmware::reader::HexReader cached{ path.string(), CustomDataTypes::ComputerScience::megabyte{1}, &cache };
+        REQUIRE(static_cast<bool>(cached));
+        REQUIRE(cached.getFileSize() == parsed.getFileSize());
+        REQUIRE(cached.getStartAddress() == parsed.getStartAddress());
+        REQUIRE(cached.image().segments().size() == 2);
+        REQUIRE(cached.image().at(0xA1) == std::byte{ 0xCF });
+
+        std::filesystem::remove_all(path);
+    }
+}
@@ -2,7 +2,9 @@
 // Created by sebastian on 15.06.19.
 //
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include <sstream>
+#include <iomanip>
 #include "../includes/intelhexclass.h"
 
 
@@ -50,5 +52,173 @@ namespace test {
         REQUIRE((*hex.begin()).address == 0);
         REQUIRE((*--hex.end()).address == 161);
     }
-}
 
+    TEST_CASE("Hex Class Checksum Test", "[General Hex Test]") {
+        intelhex hex;
+        std::istringstream buf(":100000000C9434000C943E000C943E000C943E0083\n"
+                               ":00000001FF");
+        buf >> hex;
+
+        REQUIRE(hex.size() == 0);
+        REQUIRE(hex.getNoErrors() == 1);
+    }
+
+    TEST_CASE("Hex Class Line Format Test", "[General Hex Test]") {
+        intelhex hex;
+        std::istringstream buf(":100000000c9434000c943e000c943e000c943e0082\r\n"
+                               ":0200100012G490\r\n"
+                               ":00000001FF\r\n");
+        buf >> hex;
+
+        REQUIRE(hex.size() == 16);
+        REQUIRE(static_cast<int>((*hex.begin()).data) == 0x0C);
+        REQUIRE(hex.getNoErrors() == 2);
+    }
+
+    TEST_CASE("Hex Class Overlap Test", "[General Hex Test]") {
+        intelhex hex;
+        std::istringstream buf(":020000000C945E\n"
+                               ":020000000C945E\n"
+                               ":02000100953434\n"
+                               ":00000001FF");
+        buf >> hex;
+
+        REQUIRE(hex.size() == 3);
+        REQUIRE(hex.getNoWarnings() == 2);
+        REQUIRE(hex.getNoErrors() == 1);
+    }
+
+    TEST_CASE("Hex Class Buffer Decode Test", "[General Hex Test]") {
+        intelhex streamHex;
+        std::istringstream buf(str);
+        buf >> streamHex;
+
+        intelhex bufferHex;
+        bufferHex.decode("\r\n" + str + "\r\n\r\n");
+
+        REQUIRE(bufferHex.size() == streamHex.size());
+        REQUIRE(bufferHex.getNoErrors() == 0);
+        REQUIRE(bufferHex.getNoWarnings() == 0);
+        REQUIRE(bufferHex.currentAddress() == streamHex.currentAddress());
+        REQUIRE(std::equal(bufferHex.begin(), bufferHex.end(), streamHex.begin(), [](auto lhs, auto rhs) {
+            return lhs.address == rhs.address && lhs.data == rhs.data;
+        }));
+    }
+
+    std::string hexRecord(unsigned int type, unsigned int offset, const std::vector<unsigned int>& data) {
+        std::ostringstream record;
+        record << ':' << std::uppercase << std::hex << std::setfill('0') << std::setw(2) << data.size()
+               << std::setw(4) << offset << std::setw(2) << type;
+        unsigned int checksum = static_cast<unsigned int>(data.size()) + (offset >> 8) + offset + type;
+        for (auto value : data) {
+            record << std::setw(2) << value;
+            checksum += value;
+        }
+        record << std::setw(2) << ((0x100 - (checksum & 0xFF)) & 0xFF) << '\n';
+        return record.str();
+    }
+
+    TEST_CASE("Hex Class Parallel Decode Test", "[General Hex Test]") {
+        // 0x30000 bytes spread over three 64k pages make for well over 1MB of text
+        std::string content;
+        for (unsigned int page = 0; page < 3; page++) {
+            content += hexRecord(0x04, 0, { 0, page });
+            for (unsigned int offset = 0; offset < 0x10000; offset += 16) {
+                std::vector<unsigned int> data;
+                for (unsigned int x = 0; x < 16; x++) {
+                    data.push_back((page + offset + x) & 0xFF);
+                }
+                content += hexRecord(0x00, offset, data);
+            }
+        }
+        // rewrite data of the first page, once with the same and once with other values
+        content += hexRecord(0x04, 0, { 0, 0 });
+        content += hexRecord(0x00, 0x10, { 0x10, 0x11 });
+        content += hexRecord(0x00, 0x20, { 0xAA });
+        content += hexRecord(0x05, 0, { 0, 0, 0x01, 0x00 });
+        content += hexRecord(0x01, 0, {});
+
+        intelhex serialHex;
+        serialHex.decode(content);
+
+        intelhex parallelHex;
+        parallelHex.decode(content, 4);
+
+        REQUIRE(serialHex.size() == 0x30000);
+        REQUIRE(serialHex.getNoWarnings() == 2);
+        REQUIRE(serialHex.getNoErrors() == 1);
+
+        REQUIRE(parallelHex.size() == serialHex.size());
+        REQUIRE(parallelHex.getNoWarnings() == serialHex.getNoWarnings());
+        REQUIRE(parallelHex.getNoErrors() == serialHex.getNoErrors());
+        REQUIRE(parallelHex.currentAddress() == serialHex.currentAddress());
+        REQUIRE(parallelHex.image().segments().size() == 1);
+        REQUIRE(std::equal(parallelHex.begin(), parallelHex.end(), serialHex.begin(), [](auto lhs, auto rhs) {
+            return lhs.address == rhs.address && lhs.data == rhs.data;
+        }));
+
+        unsigned long serialStart = 0;
+        unsigned long parallelStart = 0;
+        REQUIRE(serialHex.getStartLinearAddress(&serialStart));
+        REQUIRE(parallelHex.getStartLinearAddress(&parallelStart));
+        REQUIRE(parallelStart == serialStart);
+    }
+
+    TEST_CASE("Hex Class Parallel Decode Skips Damaged Address Records", "[General Hex Test]") {
+        std::string content;
+        for (unsigned int page = 0; page < 3; page++) {
+            content += hexRecord(0x04, 0, { 0, page });
+            if (page == 1) {
+                // an extended address record with a wrong checksum is skipped by the decoder
+                auto damaged = hexRecord(0x04, 0, { 0, 7 });
+                damaged.replace(damaged.size() - 3, 2, "00");
+                content += damaged;
+            }
+            for (unsigned int offset = 0; offset < 0x10000; offset += 16) {
+                std::vector<unsigned int> data;
+                for (unsigned int x = 0; x < 16; x++) {
+                    data.push_back((page + offset + x) & 0xFF);
+                }
+                content += hexRecord(0x00, offset, data);
+            }
+        }
+        content += hexRecord(0x01, 0, {});
+
+        intelhex serialHex;
+        serialHex.decode(content);
+
+        intelhex parallelHex;
+        parallelHex.decode(content, 4);
+
+        REQUIRE(serialHex.getNoErrors() == 1);
+        REQUIRE(serialHex.image().segments().size() == 1);
+        REQUIRE(parallelHex.getNoErrors() == serialHex.getNoErrors());
+        REQUIRE(parallelHex.size() == serialHex.size());
+        REQUIRE(parallelHex.image().segments().size() == 1);
+        REQUIRE(std::equal(parallelHex.begin(), parallelHex.end(), serialHex.begin(), [](auto lhs, auto rhs) {
+            return lhs.address == rhs.address && lhs.data == rhs.data;
+        }));
+    }
+
+    TEST_CASE("Hex Class Decodes Reversed Records Into One Segment", "[General Hex Test]") {
+        std::string content;
+        for (unsigned int offset = 0x10000; offset > 0; offset -= 16) {
+            std::vector<unsigned int> data;
+            for (unsigned int x = 0; x < 16; x++) {
+                data.push_back((offset - 16 + x) & 0xFF);
+            }
+            content += hexRecord(0x00, offset - 16, data);
+        }
+        content += hexRecord(0x01, 0, {});
+
+        intelhex hex;
+        hex.decode(content);
+
+        REQUIRE(hex.getNoErrors() == 0);
+        REQUIRE(hex.size() == 0x10000);
+        REQUIRE(hex.image().segments().size() == 1);
+        REQUIRE(std::all_of(hex.begin(), hex.end(), [](auto element) {
+            return element.data == static_cast<unsigned char>(element.address & 0xFF);
+        }));
+    }
+}
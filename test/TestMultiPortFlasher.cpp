@@ -0,0 +1,159 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <mutex>
+#include "testClasses/SerialTestImpl.h"
+#include "../src/loader/MultiPortFlasher.h"
+#include "../src/loader/BinReader.h"
+#include "../src/utils/fileUtils.h"
+
+namespace test {
+    const std::string multiPortJson = R"({
+  "device": {
+    "general": { "id": "atmega328p", "vendor": "Microchip", "arch": "AVR", "subarch": "ATMega", "name": "Atmega328p" },
+    "flash": { "total": "32KB", "available": "30KB" },
+    "eeprom": { "total": "1KB", "available": "1023B" }
+  },
+  "serial": {
+    "general": { "mode": "8N1", "bytesPerBurst": 2, "metadataByteSize": 2, "minBaudrate": 9600, "maxBaudrate": 57600 },
+    "write": { "waitTimeForReset": "1s", "eepromBurstDelay": "100ms", "flashBurstDelay": "1ms" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": "false" }
+  },
+  "binary": { "format": "Intel Hex", "unusedFlashByte": "0xFF" }
+})";
+
+    /**
+     * Hands the sent bytes out when the send manager releases the port.
+     */
+    class RecordingSerial : public SerialTestImpl {
+    public:
+        explicit RecordingSerial(std::vector<std::byte>& sent)
+            : SerialTestImpl{"/dev/null", 9600, serial::utils::SerialConfiguration{8, serial::utils::Parity::none, 1}},
+              mSent{sent} {}
+
+        ~RecordingSerial() override {
+            mSent = getVectorContents();
+        }
+
+    private:
+        std::vector<std::byte>& mSent;
+    };
+
+    TEST_CASE("Glob matching", "[Multi Port Test]") {
+        REQUIRE(utils::matchesGlob("ttyUSB0", "ttyUSB*"));
+        REQUIRE(utils::matchesGlob("ttyUSB12", "tty*1?"));
+        REQUIRE(utils::matchesGlob("ttyUSB", "ttyUSB*"));
+        REQUIRE(!utils::matchesGlob("ttyACM0", "ttyUSB*"));
+        REQUIRE(!utils::matchesGlob("ttyUSB10", "ttyUSB?"));
+    }
+
+    TEST_CASE("Port list expansion", "[Multi Port Test]") {
+        auto directory = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests/ports";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        for (const auto* name : {"ttyUSB1", "ttyUSB0", "ttyACM0"}) {
+            std::ofstream{directory / name};
+        }
+
+        const auto ports = firmware::serial::expandPorts((directory / "ttyUSB*").string() + ",COM3");
+        REQUIRE(ports.size() == 3);
+        REQUIRE(ports[0] == (directory / "ttyUSB0").string());
+        REQUIRE(ports[1] == (directory / "ttyUSB1").string());
+        REQUIRE(ports[2] == "COM3");
+        REQUIRE(firmware::serial::expandPorts((directory / "ttyS*").string()).empty());
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST_CASE("Multi port flashing", "[Multi Port Test]") {
+        auto directory = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests";
+        std::filesystem::create_directories(directory);
+        const auto configPath = directory / "ConfigMultiPort.json";
+        const auto binaryPath = directory / "multiport.bin";
+        {
+            std::ofstream config{configPath};
+            config << multiPortJson;
+            std::ofstream binary{binaryPath, std::ios::binary};
+            binary << "abc";
+        }
+
+        firmware::json::config::ConfigManager manager{configPath};
+        auto image = firmware::reader::FirmwareImage::freeze(
+                std::make_unique<firmware::reader::BinReader>(binaryPath.string(), CustomDataTypes::ComputerScience::byte{1024}, 0));
+        REQUIRE(*image);
+
+        std::map<std::string, std::vector<std::byte>> sent{{"a", {}}, {"b", {}}};
+        firmware::serial::MultiPortFlasher flasher{image, [&](const std::string& port) {
+            std::unique_ptr<firmware::serial::DataSendManager> sendManager;
+            if (sent.count(port) != 0) {
+                sendManager = std::make_unique<firmware::serial::DataSendManager>(
+                        manager, std::make_unique<RecordingSerial>(sent.at(port)), false);
+            }
+            return sendManager;
+        }};
+
+        std::mutex progressMutex;
+        std::vector<double> progress(3, 0.0);
+        const auto results = flasher.flash({"a", "missing", "b"}, [&](std::size_t port, double percent) {
+            std::lock_guard lock{progressMutex};
+            progress[port] = percent;
+        });
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0]);
+        REQUIRE(results[0].bytes == 3);
+        REQUIRE(!results[1]);
+        REQUIRE(results[2]);
+        REQUIRE(progress[0] == Approx(100));
+        REQUIRE(progress[2] == Approx(100));
+
+        const std::vector<std::byte> expected{std::byte{0}, std::byte{0}, std::byte{3}, std::byte{0},
+                                              std::byte{'a'}, std::byte{'b'}, std::byte{'c'}, std::byte{0xFF}};
+        REQUIRE(sent.at("a") == expected);
+        REQUIRE(sent.at("b") == expected);
+        // the workers released their references
+        REQUIRE(image.use_count() == 2);
+        std::filesystem::remove(configPath);
+        std::filesystem::remove(binaryPath);
+    }
+
+    TEST_CASE("Multi port flashing uses the options of each port", "[Multi Port Test]") {
+        auto directory = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests";
+        std::filesystem::create_directories(directory);
+        const auto configPath = directory / "ConfigMultiPortOptions.json";
+        const auto binaryPath = directory / "multiportOptions.bin";
+        {
+            std::ofstream config{configPath};
+            config << multiPortJson;
+            std::ofstream binary{binaryPath, std::ios::binary};
+            binary << "abc";
+        }
+
+        firmware::json::config::ConfigManager manager{configPath};
+        auto image = firmware::reader::FirmwareImage::freeze(
+                std::make_unique<firmware::reader::BinReader>(binaryPath.string(), CustomDataTypes::ComputerScience::byte{1024}, 0));
+        REQUIRE(*image);
+
+        // port b frames its bursts differently, e.g. because of tuned or newer options
+        auto segmented = *manager.resolved();
+        segmented.binaryTransfer = serial::utils::TransferModes::Segmented;
+        std::map<std::string, std::vector<std::byte>> sent{{"a", {}}, {"b", {}}};
+        firmware::serial::MultiPortFlasher flasher{image, [&](const std::string& port) {
+            return std::make_unique<firmware::serial::DataSendManager>(port == "a" ? *manager.resolved() : segmented,
+                    std::make_unique<RecordingSerial>(sent.at(port)), false);
+        }};
+
+        const auto results = flasher.flash({"a", "b"}, {});
+        REQUIRE(results[0]);
+        REQUIRE(results[1]);
+        REQUIRE(results[0].bytes == 3);
+        REQUIRE(results[1].bytes == 3);
+        // the segmented port announces every page of two bytes on its own
+        REQUIRE(sent.at("a").size() == 8);
+        REQUIRE(sent.at("b").size() > sent.at("a").size());
+        std::filesystem::remove(configPath);
+        std::filesystem::remove(binaryPath);
+    }
+}
@@ -0,0 +1,48 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include "../src/utils/PackBits.h"
+
+namespace test {
+    std::vector<std::byte> roundTrip(const std::vector<std::byte>& data) {
+        std::vector<std::byte> encoded;
+        utils::packBits(data, encoded);
+        auto decoded = utils::unpackBits(encoded);
+        REQUIRE(decoded.has_value());
+        return *decoded;
+    }
+
+    TEST_CASE("PackBits encodes runs and literals", "[PackBits Test]") {
+        const std::vector<std::byte> data{std::byte{1}, std::byte{2}, std::byte{0xFF}, std::byte{0xFF},
+                                          std::byte{0xFF}, std::byte{0xFF}, std::byte{3}};
+        std::vector<std::byte> encoded;
+        utils::packBits(data, encoded);
+
+        const std::vector<std::byte> expected{std::byte{1}, std::byte{1}, std::byte{2},
+                                              std::byte{0xFD}, std::byte{0xFF},
+                                              std::byte{0}, std::byte{3}};
+        REQUIRE(encoded == expected);
+        REQUIRE(roundTrip(data) == data);
+    }
+
+    TEST_CASE("PackBits splits long packets", "[PackBits Test]") {
+        std::vector<std::byte> data(300, std::byte{0xFF});
+        for (std::size_t i = 0; i < 300; i++) {
+            data.push_back(std::byte(i));
+        }
+        std::vector<std::byte> encoded;
+        utils::packBits(data, encoded);
+        REQUIRE(encoded.size() < data.size());
+        REQUIRE(roundTrip(data) == data);
+        REQUIRE(roundTrip({}).empty());
+    }
+
+    TEST_CASE("PackBits rejects truncated packets", "[PackBits Test]") {
+        const std::vector<std::byte> literal{std::byte{3}, std::byte{1}};
+        REQUIRE(!utils::unpackBits(literal).has_value());
+        const std::vector<std::byte> run{std::byte{0xFE}};
+        REQUIRE(!utils::unpackBits(run).has_value());
+    }
+}
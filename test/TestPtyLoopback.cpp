@@ -0,0 +1,74 @@
+//
+// Created on 16.10.26.
+//
+
+#ifdef __linux__
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include "testClasses/PtyLoopback.h"
+#include "testClasses/SerialTestImpl.h"
+#include "../src/loader/DataSendManager.h"
+#include "../src/loader/BinReader.h"
+
+namespace test {
+    const std::string ptyJson = R"({
+  "device": {
+    "general": { "id": "atmega328p", "vendor": "Microchip", "arch": "AVR", "subarch": "ATMega", "name": "Atmega328p" },
+    "flash": { "total": "32KB", "available": "30KB" },
+    "eeprom": { "total": "1KB", "available": "1023B" }
+  },
+  "serial": {
+    "general": { "mode": "8N1", "bytesPerBurst": 64, "metadataByteSize": 2, "minBaudrate": 9600, "maxBaudrate": 115200 },
+    "write": { "waitTimeForReset": "0ms", "eepromBurstDelay": "2ms", "flashBurstDelay": "2ms" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": "false" }
+  },
+  "binary": { "format": "Binary", "unusedFlashByte": "0xFF" }
+})";
+
+    TEST_CASE("Flashing through a pseudo terminal", "[Pty Loopback Test]") {
+        const auto folder = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests/Pty";
+        std::filesystem::create_directories(folder);
+        std::ofstream{folder / "config.json"} << ptyJson;
+        {
+            std::ofstream image{folder / "image.bin", std::ios::binary};
+            for (int i = 0; i < 2048; ++i) {
+                image.put(static_cast<char>(i * 13));
+            }
+        }
+
+        using namespace CustomDataTypes::ComputerScience::literals;
+        firmware::json::config::ConfigManager config{folder / "config.json"};
+        firmware::reader::BinReader reader{(folder / "image.bin").string(), 30_kB};
+        REQUIRE(static_cast<bool>(reader));
+
+        std::unique_ptr<AbstractSerial> reference = std::make_unique<SerialTestImpl>("/dev/null", 115200,
+                serial::utils::SerialConfiguration{8, serial::utils::Parity::none, 1});
+        const auto& expected = dynamic_cast<SerialTestImpl*>(reference.get())->getVectorContents();
+        firmware::serial::DataSendManager referenceManager{config, std::move(reference), false};
+        reader.writeToStream(referenceManager, [](double) {});
+        referenceManager.flush();
+
+        PtyLoopback loopback;
+        REQUIRE(static_cast<bool>(loopback));
+        {
+            const std::string& device = loopback.devicePath();
+            firmware::serial::DataSendManager manager{config, {device, 115200}, std::chrono::milliseconds{0}};
+            REQUIRE(manager.isOpen());
+            reader.writeToStream(manager, [](double) {});
+            manager.flush();
+        }
+
+        REQUIRE(loopback.waitFor(expected.size(), std::chrono::seconds{5}));
+        REQUIRE(loopback.received() == expected);
+
+        const auto report = loopback.report(std::chrono::microseconds{1000}, std::chrono::microseconds{2000});
+        REQUIRE(report.bytes == expected.size());
+        REQUIRE(report.bursts > 1);
+        // bursts are never sent before the delay is over, late ones only raise the mean
+        REQUIRE(report.meanGap >= std::chrono::microseconds{1800});
+        std::filesystem::remove_all(folder);
+    }
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <catch2/catch.hpp>
 #include "testClasses/SerialTestImpl.h"
 #include "../src/loader/DataSendManager.h"
+#include "../src/loader/BinReader.h"
 
 const std::string jsonString = R"({
   "device": {
@@ -120,4 +121,199 @@ namespace test {
         std::filesystem::remove_all(path);
     }
 
-}
\ No newline at end of file
+    TEST_CASE("Serial Consecutive Writes Test", "[Serial Test]") {
+        std::unique_ptr<AbstractSerial> serialImplPtr = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                                                         serial::utils::SerialConfiguration{
+                                                                                                 8,
+                                                                                                 serial::utils::Parity::none,
+                                                                                                 1});
+
+        auto path = pathSetup();
+        firmware::json::config::ConfigManager manager{path};
+        const auto& val = dynamic_cast<SerialTestImpl*>(serialImplPtr.get())->getVectorContents();
+
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImplPtr), false};
+        sendManager.bufferedWrite({std::byte{0}});
+        sendManager.bufferedWrite({std::byte{1}, std::byte{2}});
+        sendManager.flush();
+
+        REQUIRE(val.size() == 12);
+        REQUIRE(val.at(4) == std::byte{0});
+        REQUIRE(val.at(5) == std::byte{1});
+        REQUIRE(val.at(10) == std::byte{2});
+        REQUIRE(val.at(11) == std::byte{0xFF});
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("Serial Bulk Write Test", "[Serial Test]") {
+        std::unique_ptr<AbstractSerial> serialImplPtr = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                                                         serial::utils::SerialConfiguration{
+                                                                                                 8,
+                                                                                                 serial::utils::Parity::none,
+                                                                                                 1});
+
+        auto path = pathSetup();
+        firmware::json::config::ConfigManager manager{path};
+        const auto& val = dynamic_cast<SerialTestImpl*>(serialImplPtr.get())->getVectorContents();
+
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImplPtr), false};
+        const std::vector<std::byte> data{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}};
+        sendManager.bufferedWrite(std::byte{0});
+        sendManager.write(data);
+
+        // two complete bursts of two bytes, each after a sync frame
+        REQUIRE(val.size() == 12);
+        REQUIRE(val.at(4) == std::byte{0});
+        REQUIRE(val.at(5) == std::byte{1});
+        REQUIRE(val.at(10) == std::byte{2});
+        REQUIRE(val.at(11) == std::byte{3});
+
+        sendManager.flush();
+        REQUIRE(val.size() == 18);
+        REQUIRE(val.at(16) == std::byte{4});
+        REQUIRE(val.at(17) == std::byte{0xFF});
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("Serial Pipelined Write Test", "[Serial Test]") {
+        std::unique_ptr<AbstractSerial> serialImplPtr = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                                                         serial::utils::SerialConfiguration{
+                                                                                                 8,
+                                                                                                 serial::utils::Parity::none,
+                                                                                                 1});
+
+        auto path = pathSetup();
+        firmware::json::config::ConfigManager manager{path};
+        const auto& val = dynamic_cast<SerialTestImpl*>(serialImplPtr.get())->getVectorContents();
+
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImplPtr), false};
+        sendManager.enablePipelining();
+        sendManager.write(std::vector<std::byte>{std::byte{0}, std::byte{1}, std::byte{2}});
+        sendManager.flush();
+
+        REQUIRE(val.size() == 12);
+        REQUIRE(val.at(4) == std::byte{0});
+        REQUIRE(val.at(5) == std::byte{1});
+        REQUIRE(val.at(10) == std::byte{2});
+        REQUIRE(val.at(11) == std::byte{0xFF});
+        std::filesystem::remove_all(path);
+    }
+
+    [[nodiscard]] std::filesystem::path acknowledgedPathSetup() {
+        auto path = std::filesystem::path{std::filesystem::temp_directory_path()};
+        path /= "FiremwareLoaderTests/ConfigManagerAck.json";
+        std::filesystem::create_directories(path.parent_path());
+
+        auto content = jsonString;
+        const std::string resync = R"("resyncAfterBurst": "true")";
+        content.replace(content.find(resync), resync.size(),
+                        R"("resyncAfterBurst": "false", "ackByte": "0x06", "ackWindow": 2, "ackTimeout": "10ms")");
+        {
+            std::ofstream stream{path};
+            stream << content;
+        }
+        return path;
+    }
+
+    TEST_CASE("Serial Acknowledged Transmission Test", "[Serial Test]") {
+        auto serialImpl = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                           serial::utils::SerialConfiguration{
+                                                                   8,
+                                                                   serial::utils::Parity::none,
+                                                                   1});
+        serialImpl->scriptReceivedBytes({std::byte{0x06}, std::byte{0x06}, std::byte{0x06}});
+        const auto& val = serialImpl->getVectorContents();
+
+        auto path = acknowledgedPathSetup();
+        firmware::json::config::ConfigManager manager{path};
+        REQUIRE(manager.resolved()->serialAckByte == std::byte{0x06});
+        REQUIRE(manager.resolved()->serialAckWindow == 2);
+
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImpl), false};
+        sendManager.write(std::vector<std::byte>{std::byte{0}, std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}});
+        sendManager.flush();
+
+        // no resync, so the bursts follow each other directly
+        REQUIRE(val.size() == 6);
+        REQUIRE(val.at(4) == std::byte{4});
+        REQUIRE(val.at(5) == std::byte{0xFF});
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("Serial Missing Acknowledgement Test", "[Serial Test]") {
+        auto serialImpl = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                           serial::utils::SerialConfiguration{
+                                                                   8,
+                                                                   serial::utils::Parity::none,
+                                                                   1});
+        serialImpl->scriptReceivedBytes({std::byte{0x06}, std::byte{0x15}});
+
+        auto path = acknowledgedPathSetup();
+        firmware::json::config::ConfigManager manager{path};
+
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImpl), false};
+        sendManager.write(std::vector<std::byte>{std::byte{0}, std::byte{1}, std::byte{2}, std::byte{3}});
+        REQUIRE_THROWS_AS(sendManager.write(std::vector<std::byte>{std::byte{4}, std::byte{5}}), std::runtime_error);
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("Serial Restart After A Failed Transfer Test", "[Serial Test]") {
+        auto serialImpl = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                           serial::utils::SerialConfiguration{
+                                                                   8,
+                                                                   serial::utils::Parity::none,
+                                                                   1});
+        auto* serial = serialImpl.get();
+        serial->scriptReceivedBytes({std::byte{0x15}});
+        const auto& val = serial->getVectorContents();
+
+        auto path = acknowledgedPathSetup();
+        firmware::json::config::ConfigManager manager{path};
+
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImpl), false};
+        sendManager.enablePipelining();
+        sendManager.write(std::vector<std::byte>{std::byte{0}, std::byte{1}, std::byte{2}, std::byte{3}});
+        REQUIRE_THROWS_AS(sendManager.flush(), std::runtime_error);
+
+        // the next job on the same port must not see the old failure
+        sendManager.restart();
+        serial->scriptReceivedBytes({std::byte{0x06}, std::byte{0x06}, std::byte{0x06}});
+        sendManager.write(std::vector<std::byte>{std::byte{4}, std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}});
+        REQUIRE_NOTHROW(sendManager.flush());
+        REQUIRE(val.at(val.size() - 2) == std::byte{8});
+        REQUIRE(val.back() == std::byte{0xFF});
+        std::filesystem::remove_all(path);
+    }
+
+    TEST_CASE("Serial Segmented Transfer Test", "[Serial Test]") {
+        auto serialImpl = std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                                                           serial::utils::SerialConfiguration{
+                                                                   8,
+                                                                   serial::utils::Parity::none,
+                                                                   1});
+        serialImpl->scriptReceivedBytes(std::vector<std::byte>(8, std::byte{0x06}));
+        const auto& val = serialImpl->getVectorContents();
+
+        auto binaryPath = std::filesystem::path{std::filesystem::temp_directory_path()} / "FiremwareLoaderTests/segmented.bin";
+        std::filesystem::create_directories(binaryPath.parent_path());
+        {
+            std::ofstream stream{binaryPath, std::ios::binary};
+            stream << "abc";
+        }
+        firmware::reader::BinReader reader{binaryPath.string(), CustomDataTypes::ComputerScience::byte{1024}, 0x10};
+
+        auto path = acknowledgedPathSetup();
+        firmware::json::config::ConfigManager manager{path};
+        auto sendManager = firmware::serial::DataSendManager{manager, std::move(serialImpl), false};
+        reader.writeRanges(sendManager, firmware::reader::fullTransfer(reader.image()));
+        sendManager.flush();
+
+        const std::vector<std::byte> expected{std::byte{0x10}, std::byte{0}, std::byte{3}, std::byte{0},
+                                              std::byte{'a'}, std::byte{'b'}, std::byte{'c'}, std::byte{0xFF},
+                                              std::byte{0}, std::byte{0}, std::byte{0}, std::byte{0}};
+        REQUIRE(val == expected);
+        std::filesystem::remove_all(path);
+        std::filesystem::remove(binaryPath);
+    }
+
+}
@@ -0,0 +1,101 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include "../src/loader/SparseImage.h"
+
+namespace test {
+    using firmware::reader::SparseImage;
+
+    TEST_CASE("Sparse Image merges contiguous data", "[Sparse Image Test]") {
+        SparseImage image;
+        for (unsigned long address = 0x100; address < 0x110; address++) {
+            REQUIRE(image.insert(address, std::byte(address & 0xFF)) == SparseImage::InsertResult::Inserted);
+        }
+
+        REQUIRE(image.size() == 16);
+        REQUIRE(image.segments().size() == 1);
+        REQUIRE(image.startAddress() == 0x100);
+        REQUIRE(image.endAddress() == 0x110);
+        REQUIRE(*image.at(0x105) == std::byte{0x05});
+        REQUIRE(!image.at(0x110).has_value());
+    }
+
+    TEST_CASE("Sparse Image keeps gaps and closes them", "[Sparse Image Test]") {
+        SparseImage image;
+        image.insert(0x20, std::byte{0xAA});
+        image.insert(0x00, std::byte{0x01});
+        image.insert(0x02, std::byte{0x03});
+
+        REQUIRE(image.segments().size() == 3);
+        REQUIRE(image.segments().front().address == 0x00);
+
+        image.insert(0x01, std::byte{0x02});
+        REQUIRE(image.segments().size() == 2);
+        REQUIRE(image.segments().front().data.size() == 3);
+
+        image.insert(0x1F, std::byte{0x99});
+        REQUIRE(image.segments().back().address == 0x1F);
+        REQUIRE(image.size() == 5);
+    }
+
+    TEST_CASE("Sparse Image reports overlaps", "[Sparse Image Test]") {
+        SparseImage image;
+        image.insert(0x10, std::byte{0x01});
+
+        REQUIRE(image.insert(0x10, std::byte{0x01}) == SparseImage::InsertResult::Duplicate);
+        REQUIRE(image.insert(0x10, std::byte{0x02}) == SparseImage::InsertResult::Conflict);
+        REQUIRE(*image.at(0x10) == std::byte{0x01});
+        REQUIRE(image.size() == 1);
+    }
+
+    TEST_CASE("Sparse Image Iterator", "[Sparse Image Test]") {
+        SparseImage image;
+        REQUIRE(image.begin() == image.end());
+
+        image.insert(0x00, std::byte{0x01});
+        image.insert(0x01, std::byte{0x02});
+        image.insert(0x40, std::byte{0x03});
+
+        std::size_t elements = 0;
+        for (const auto& e : image) {
+            (void) e;
+            elements++;
+        }
+
+        REQUIRE(elements == 3);
+        REQUIRE((*image.begin()).address == 0x00);
+        REQUIRE((*++image.begin()).data == std::byte{0x02});
+        REQUIRE((*--image.end()).address == 0x40);
+        REQUIRE((*image.find(0x01)).data == std::byte{0x02});
+        REQUIRE(image.find(0x02) == image.end());
+    }
+
+    TEST_CASE("Sparse Image coalesces descending runs", "[Sparse Image Test]") {
+        SparseImage image;
+        for (unsigned long address = 0x1000; address-- > 0x800; ) {
+            REQUIRE(image.insert(address, std::byte(address & 0xFF)) == SparseImage::InsertResult::Inserted);
+        }
+        // reversed records, every run is ascending on its own
+        for (unsigned long record = 0x800; record > 0; record -= 0x10) {
+            for (unsigned long address = record - 0x10; address < record; address++) {
+                REQUIRE(image.insert(address, std::byte(address & 0xFF)) == SparseImage::InsertResult::Inserted);
+            }
+        }
+
+        // insert() only leaves a few runs of growing size apart
+        REQUIRE(image.segments().size() <= 16);
+        REQUIRE(image.size() == 0x1000);
+
+        image.coalesce();
+        REQUIRE(image.segments().size() == 1);
+        REQUIRE(image.startAddress() == 0x00);
+        REQUIRE(image.endAddress() == 0x1000);
+        const auto& data = image.segments().front().data;
+        for (std::size_t address = 0; address < data.size(); address++) {
+            REQUIRE(data[address] == std::byte(address & 0xFF));
+        }
+        REQUIRE(image.insert(0x0FFF, std::byte{ 0xFF }) == SparseImage::InsertResult::Duplicate);
+    }
+}
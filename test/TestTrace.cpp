@@ -0,0 +1,114 @@
+//
+// Created on 16.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "testClasses/SerialTestImpl.h"
+#include "../src/loader/DataSendManager.h"
+#include "../src/utils/Trace.h"
+
+namespace test {
+    const std::string traceJson = R"({
+  "device": {
+    "general": { "id": "atmega328p", "vendor": "Microchip", "arch": "AVR", "subarch": "ATMega", "name": "Atmega328p" },
+    "flash": { "total": "32KB", "available": "30KB" },
+    "eeprom": { "total": "1KB", "available": "1023B" }
+  },
+  "serial": {
+    "general": { "mode": "8N1", "bytesPerBurst": 2, "metadataByteSize": 2, "minBaudrate": 9600, "maxBaudrate": 57600 },
+    "write": { "waitTimeForReset": "0ms", "eepromBurstDelay": "0ms", "flashBurstDelay": "3ms" },
+    "sync": { "syncByteAmount": 3, "syncByte": "0xCC", "preamble": "0x55", "resyncAfterBurst": "false" }
+  },
+  "binary": { "format": "Intel Hex", "unusedFlashByte": "0xFF" }
+})";
+
+    std::size_t countEvents(const std::vector<utils::trace::Event>& events, const std::string& name) {
+        return static_cast<std::size_t>(std::count_if(std::begin(events), std::end(events),
+                [&name](const utils::trace::Event& event) { return event.name == name; }));
+    }
+
+    TEST_CASE("Spans are only recorded while tracing is enabled", "[Trace]") {
+        utils::trace::enable();
+        utils::trace::disable();
+        { const utils::trace::Span span{ "ignored", "test" }; }
+        REQUIRE(utils::trace::events().empty());
+
+        utils::trace::enable();
+        {
+            const utils::trace::Span outer{ "outer", "test" };
+            const utils::trace::Span inner{ "inner", "test", 42 };
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+        }
+        utils::trace::disable();
+
+        const auto events = utils::trace::events();
+        REQUIRE(events.size() == 2);
+        const auto& inner = events.at(0);
+        const auto& outer = events.at(1);
+        REQUIRE(inner.name == "inner");
+        REQUIRE(inner.bytes == 42);
+        REQUIRE(outer.name == "outer");
+        REQUIRE(outer.category == "test");
+        REQUIRE(inner.thread == outer.thread);
+        REQUIRE(inner.duration >= std::chrono::milliseconds{ 2 });
+        REQUIRE(outer.start <= inner.start);
+        REQUIRE(outer.start + outer.duration >= inner.start + inner.duration);
+    }
+
+    TEST_CASE("A transfer records its bursts and pacing sleeps", "[Trace]") {
+        const auto path = std::filesystem::temp_directory_path() / "FiremwareLoaderTests/Trace.json";
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream{ path } << traceJson;
+        const firmware::json::config::ConfigManager config{ path };
+
+        utils::trace::enable();
+        {
+            firmware::serial::DataSendManager manager{ config, std::make_unique<SerialTestImpl>("/dev/null", 9600,
+                    serial::utils::SerialConfiguration{ 8, serial::utils::Parity::none, 1 }), false };
+            manager.metadataWrite({ std::byte{ 0x00 }, std::byte{ 0x01 } });
+            manager.bufferedWrite({ std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } });
+            manager.flush();
+        }
+        utils::trace::disable();
+
+        const auto events = utils::trace::events();
+        REQUIRE(countEvents(events, "metadata") == 1);
+        REQUIRE(countEvents(events, "burst") == 3);
+        REQUIRE(countEvents(events, "pacing") == 3);
+        REQUIRE(countEvents(events, "flush") == 1);
+        for (const auto& event : events) {
+            if (event.name == "burst") {
+                REQUIRE(event.bytes == 2);
+            }
+            if (event.name == "pacing") {
+                REQUIRE(event.duration >= std::chrono::milliseconds{ 3 });
+            }
+        }
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("The trace is exported in the Chrome trace event format", "[Trace]") {
+        utils::trace::enable();
+        { const utils::trace::Span span{ "quoted \"name\"\n", "test", 7 }; }
+        utils::trace::disable();
+
+        const auto path = std::filesystem::temp_directory_path() / "FiremwareLoaderTests/trace.json";
+        std::filesystem::create_directories(path.parent_path());
+        REQUIRE(utils::trace::writeChromeTrace(path));
+        std::stringstream content;
+        content << std::ifstream{ path }.rdbuf();
+        const auto trace = content.str();
+
+        REQUIRE(trace.rfind(R"({"displayTimeUnit":"ms","traceEvents":[)", 0) == 0);
+        REQUIRE(trace.find(R"({"name":"quoted \"name\"\u000a","cat":"test","ph":"X","pid":1,"tid":)") != std::string::npos);
+        REQUIRE(trace.find(R"("ts":)") != std::string::npos);
+        REQUIRE(trace.find(R"("dur":)") != std::string::npos);
+        REQUIRE(trace.find(R"("args":{"bytes":7}})") != std::string::npos);
+        REQUIRE(std::count(std::begin(trace), std::end(trace), '{') == std::count(std::begin(trace), std::end(trace), '}'));
+        std::filesystem::remove(path);
+    }
+}
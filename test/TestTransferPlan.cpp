@@ -0,0 +1,49 @@
+//
+// Created on 15.10.26.
+//
+
+#include <catch2/catch.hpp>
+#include "../src/loader/TransferPlan.h"
+
+namespace test {
+    TEST_CASE("Transfer Plan elides blank blocks", "[Transfer Plan Test]") {
+        firmware::reader::SparseImage image;
+        for (unsigned long address = 0; address < 64; address++) {
+            image.insert(address, address >= 8 && address < 40 ? std::byte{0xFF} : std::byte(address));
+        }
+        image.insert(0x100, std::byte{0xFF});
+
+        const auto plan = firmware::reader::elideBlankBlocks(firmware::reader::fullTransfer(image), 16, std::byte{0xFF});
+        REQUIRE(plan.size() == 2);
+        REQUIRE(plan[0].address == 0);
+        REQUIRE(plan[0].data.size() == 16);
+        REQUIRE(plan[1].address == 32);
+        REQUIRE(plan[1].data.size() == 32);
+        REQUIRE(firmware::reader::transferSize(plan) == 48);
+    }
+
+    TEST_CASE("Transfer Plan keeps everything without a block size", "[Transfer Plan Test]") {
+        firmware::reader::SparseImage image;
+        image.insert(4, std::byte{0xFF});
+        image.insert(5, std::byte{0xFF});
+
+        const auto full = firmware::reader::fullTransfer(image);
+        REQUIRE(firmware::reader::transferSize(firmware::reader::elideBlankBlocks(full, 0, std::byte{0xFF})) == 2);
+        REQUIRE(firmware::reader::elideBlankBlocks(full, 4, std::byte{0xFF}).empty());
+    }
+
+    TEST_CASE("Transfer Plan limits ranges to the requested window", "[Transfer Plan Test]") {
+        firmware::reader::SparseImage image;
+        for (unsigned long address = 0; address < 8; address++) {
+            image.insert(address, std::byte(address));
+            image.insert(address + 16, std::byte(address));
+        }
+
+        const auto plan = firmware::reader::transferRange(image, 4, 20);
+        REQUIRE(plan.size() == 2);
+        REQUIRE(plan[0].address == 4);
+        REQUIRE(plan[0].data.size() == 4);
+        REQUIRE(plan[1].address == 16);
+        REQUIRE(plan[1].data.size() == 4);
+    }
+}
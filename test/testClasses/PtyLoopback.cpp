@@ -0,0 +1,146 @@
+//
+// Created on 16.10.26.
+//
+
+#include "PtyLoopback.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+PtyLoopback::PtyLoopback() {
+    mMaster = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (mMaster < 0 || ::grantpt(mMaster) != 0 || ::unlockpt(mMaster) != 0) {
+        mErrorMessage = std::string{ "Unable to create a pseudo terminal: " } + std::strerror(errno);
+        return;
+    }
+    mDevicePath = ::ptsname(mMaster);
+    // keeping the slave open prevents hangups on the master end while the
+    // port under test is closed or reopened
+    mSlave = ::open(mDevicePath.c_str(), O_RDWR | O_NOCTTY);
+    if (mSlave < 0) {
+        mErrorMessage = "Unable to open " + mDevicePath + ": " + std::strerror(errno);
+        return;
+    }
+    termios settings{};
+    ::tcgetattr(mSlave, &settings);
+    ::cfmakeraw(&settings);
+    ::tcsetattr(mSlave, TCSANOW, &settings);
+
+    mRunning = true;
+    mReader = std::thread{ [this]() { readLoop(); } };
+}
+
+PtyLoopback::~PtyLoopback() {
+    mRunning = false;
+    if (mReader.joinable()) {
+        mReader.join();
+    }
+    if (mSlave >= 0) {
+        ::close(mSlave);
+    }
+    if (mMaster >= 0) {
+        ::close(mMaster);
+    }
+}
+
+const std::string& PtyLoopback::devicePath() const noexcept {
+    return mDevicePath;
+}
+
+const std::optional<std::string>& PtyLoopback::errorMessage() const noexcept {
+    return mErrorMessage;
+}
+
+PtyLoopback::operator bool() const noexcept {
+    return !mErrorMessage;
+}
+
+bool PtyLoopback::waitFor(std::size_t bytes, std::chrono::milliseconds timeout) {
+    std::unique_lock lock{ mMutex };
+    return mArrived.wait_for(lock, timeout, [&]() { return mReceived.size() >= bytes; });
+}
+
+void PtyLoopback::clear() {
+    std::lock_guard lock{ mMutex };
+    mReceived.clear();
+    mArrivals.clear();
+}
+
+std::vector<std::byte> PtyLoopback::received() const {
+    std::lock_guard lock{ mMutex };
+    return mReceived;
+}
+
+std::vector<PtyLoopback::Arrival> PtyLoopback::arrivals() const {
+    std::lock_guard lock{ mMutex };
+    return mArrivals;
+}
+
+PtyLoopback::Report PtyLoopback::report(std::chrono::microseconds burstThreshold, std::chrono::microseconds expectedGap) const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    const auto arrivals = this->arrivals();
+    Report report{ 0, 0, microseconds{ 0 }, 0.0, {}, microseconds{ 0 }, microseconds{ 0 } };
+    if (arrivals.empty()) {
+        return report;
+    }
+    report.bursts = 1;
+    for (std::size_t i = 0; i < arrivals.size(); ++i) {
+        report.bytes += arrivals[i].bytes;
+        if (i == 0) {
+            continue;
+        }
+        const auto gap = duration_cast<microseconds>(arrivals[i].time - arrivals[i - 1].time);
+        if (gap >= burstThreshold) {
+            report.bursts++;
+            report.gaps.push_back(gap);
+        }
+    }
+    report.duration = duration_cast<microseconds>(arrivals.back().time - arrivals.front().time);
+    if (report.duration.count() > 0) {
+        report.bytesPerSecond = static_cast<double>(report.bytes) * 1e6 / static_cast<double>(report.duration.count());
+    }
+    if (!report.gaps.empty()) {
+        microseconds total{ 0 };
+        for (const auto gap : report.gaps) {
+            total += gap;
+            report.maxPacingError = std::max(report.maxPacingError, microseconds{ std::abs((gap - expectedGap).count()) });
+        }
+        report.meanGap = total / static_cast<long>(report.gaps.size());
+    }
+    return report;
+}
+
+void PtyLoopback::readLoop() {
+    std::array<std::byte, 4096> buffer{};
+    while (mRunning) {
+        pollfd descriptor{ mMaster, POLLIN, 0 };
+        if (::poll(&descriptor, 1, 20) <= 0 || (descriptor.revents & POLLIN) == 0) {
+            continue;
+        }
+        const auto length = ::read(mMaster, buffer.data(), buffer.size());
+        const auto time = clock::now();
+        if (length <= 0) {
+            continue;
+        }
+        {
+            std::lock_guard lock{ mMutex };
+            const auto bytes = static_cast<std::size_t>(length);
+            mReceived.insert(std::end(mReceived), std::begin(buffer), std::begin(buffer) + length);
+            mArrivals.push_back(Arrival{ time, bytes });
+        }
+        mArrived.notify_all();
+    }
+}
+
+#endif
@@ -0,0 +1,99 @@
+//
+// Created on 16.10.26.
+//
+
+#pragma once
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Pseudo terminal pair standing in for a device. SerialImpl opens the slave
+ * end like a real serial port, a thread reads the master end and records
+ * when each chunk of bytes arrived.
+ *
+ * A pty neither enforces the baudrate nor the character timing, so the
+ * report measures the pacing of the sender (burst delays, drain) and the
+ * overhead of the real asio/termios path, not the wire speed.
+ */
+class PtyLoopback {
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Arrival {
+        clock::time_point time;
+        std::size_t bytes;
+    };
+
+    struct Report {
+        std::size_t bytes;
+        std::size_t bursts;
+        std::chrono::microseconds duration;
+        double bytesPerSecond;
+        // idle time between the end of one burst and the start of the next
+        std::vector<std::chrono::microseconds> gaps;
+        std::chrono::microseconds meanGap;
+        // largest deviation of a gap from the expected burst delay
+        std::chrono::microseconds maxPacingError;
+    };
+
+    PtyLoopback();
+
+    ~PtyLoopback();
+
+    PtyLoopback(const PtyLoopback&) = delete;
+
+    PtyLoopback& operator=(const PtyLoopback&) = delete;
+
+    [[nodiscard]] const std::string& devicePath() const noexcept;
+
+    [[nodiscard]] const std::optional<std::string>& errorMessage() const noexcept;
+
+    explicit operator bool() const noexcept;
+
+    /**
+     * Waits until at least the given number of bytes arrived. Returns false
+     * if the timeout expired first.
+     */
+    bool waitFor(std::size_t bytes, std::chrono::milliseconds timeout);
+
+    /**
+     * Forgets everything received so far, e.g. between two flashes.
+     */
+    void clear();
+
+    [[nodiscard]] std::vector<std::byte> received() const;
+
+    [[nodiscard]] std::vector<Arrival> arrivals() const;
+
+    /**
+     * Splits the arrivals into bursts at every pause of at least
+     * burstThreshold and compares the pauses with the expected delay.
+     */
+    [[nodiscard]] Report report(std::chrono::microseconds burstThreshold, std::chrono::microseconds expectedGap) const;
+
+private:
+    void readLoop();
+
+    int mMaster{ -1 };
+    int mSlave{ -1 };
+    std::string mDevicePath;
+    std::optional<std::string> mErrorMessage{ std::nullopt };
+    std::atomic<bool> mRunning{ false };
+    std::thread mReader;
+    mutable std::mutex mMutex;
+    std::condition_variable mArrived;
+    std::vector<std::byte> mReceived;
+    std::vector<Arrival> mArrivals;
+};
+
+#endif
@@ -13,10 +13,14 @@ void SerialTestImpl::writeData(std::byte data) {
     mVector.push_back(data);
 }
 
-void SerialTestImpl::writeData(const std::vector<std::byte> &data) {
+void SerialTestImpl::writeData(std::span<const std::byte> data) {
     mVector.insert(std::end(mVector), std::begin(data), std::end(data));
 }
 
+bool SerialTestImpl::drain() {
+    return true;
+}
+
 std::optional<std::string> SerialTestImpl::reciveByte() {
     return std::nullopt;
 }
@@ -25,6 +29,19 @@ std::vector<std::byte> SerialTestImpl::reciveBytes() {
     return mVector;
 }
 
+std::optional<std::byte> SerialTestImpl::reciveByteFor(std::chrono::milliseconds) {
+    if (mReceived.empty()) {
+        return std::nullopt;
+    }
+    auto value = mReceived.front();
+    mReceived.pop_front();
+    return value;
+}
+
+void SerialTestImpl::scriptReceivedBytes(const std::vector<std::byte>& data) {
+    mReceived.insert(std::end(mReceived), std::begin(data), std::end(data));
+}
+
 bool SerialTestImpl::isOpen() const {
     return true;
 }
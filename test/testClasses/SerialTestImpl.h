@@ -5,6 +5,7 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include "../../src/serial/AbstractSerial.h"
 
 class SerialTestImpl : public AbstractSerial {
@@ -13,12 +14,21 @@ public:
 
     void writeData(std::byte data) override;
 
-    void writeData(const std::vector<std::byte>& data) override;
+    void writeData(std::span<const std::byte> data) override;
+
+    bool drain() override;
 
     std::optional<std::string> reciveByte() override;
 
     std::vector<std::byte> reciveBytes() override;
 
+    std::optional<std::byte> reciveByteFor(std::chrono::milliseconds timeout) override;
+
+    /**
+     * Bytes returned by reciveByteFor, as if the device had sent them.
+     */
+    void scriptReceivedBytes(const std::vector<std::byte>& data);
+
     [[nodiscard]] bool isOpen() const override;
 
     [[nodiscard]] std::optional<std::string> errorMessage() const override;
@@ -28,6 +38,7 @@ public:
     [[nodiscard]] const std::vector<std::byte>& getVectorContents() const;
 private:
     std::vector<std::byte> mVector;
+    std::deque<std::byte> mReceived;
     std::string mDevice;
     unsigned int mBaudrate;
     serial::utils::SerialConfiguration mConfig;